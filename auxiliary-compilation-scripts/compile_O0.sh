@@ -1,4 +1,8 @@
-g++ -O0 -c src/main.cpp -Iinclude -o main.o
-g++ -O0 -c src/image.cpp -Iinclude -o image.o
-g++ -O0 -c src/convolution.cpp -Iinclude -o convolution.o
-g++ main.o image.o convolution.o -o main_O0
\ No newline at end of file
+#!/bin/bash
+set -e
+
+# Builds the -O0 benchmark variant (no sanitizers) into build-bench/bench/O0/.
+# Each variant has its own object directory, so variants never overwrite
+# each other's objects.
+cmake -S . -B build-bench -DCMAKE_BUILD_TYPE=Release
+cmake --build build-bench --target bench-O0
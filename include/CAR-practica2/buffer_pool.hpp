@@ -0,0 +1,168 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Size‑class pool of large, reusable byte buffers.
+ *
+ * Image pixels, stb_image decode buffers and JPEG scratch space are drawn
+ * from here instead of the general heap. Released buffers are cached per
+ * size class and handed out again, so a long batch of similarly sized
+ * frames stops calling malloc/mmap (and stops page faulting) after the
+ * first few images.
+ *
+ * Size classes have four steps per power of two (4, 5, 6, 7 × 2^k KiB…),
+ * which bounds the wasted tail to 25 %. Every block carries a small header
+ * recording its class, so release() and reallocate() need only the
+ * pointer — the interface stb_image expects for STBI_MALLOC/STBI_FREE.
+ *
+ * Blocks of at least kHugePageBytes can be backed by huge pages (see
+ * set_huge_pages()); they are then mapped with mmap, 2 MiB aligned, and
+ * either advised with MADV_HUGEPAGE or mapped from the hugetlbfs pool.
+ *
+ * Pools can be tied to a NUMA node (for_node()); their fresh blocks are
+ * mbind'ed to it. Threads draw from local(), which is global() unless a
+ * worker selected its node's pool with set_local(). A block always returns
+ * to the pool that created it, whichever thread releases it.
+ */
+class BufferPool
+{
+public:
+    /// Alignment of every returned pointer.
+    static constexpr size_t kAlignment = 64;
+    /// Smallest size class in bytes.
+    static constexpr size_t kMinClassBytes = 4096;
+    /// Huge page size (x86‑64); smaller blocks never use huge pages.
+    static constexpr size_t kHugePageBytes = size_t(2) << 20;
+
+    /**
+     * @brief How large blocks are backed.
+     */
+    enum class HugePages
+    {
+        Off,         ///< Regular heap allocation.
+        Transparent, ///< mmap + madvise(MADV_HUGEPAGE) (needs THP "madvise" or "always").
+        Explicit     ///< mmap(MAP_HUGETLB); falls back to Transparent if no huge pages are reserved.
+    };
+
+    struct Stats
+    {
+        uint64_t hits = 0;         ///< Requests served from the cache.
+        uint64_t misses = 0;       ///< Requests that went to the system allocator.
+        uint64_t cached_bytes = 0; ///< Bytes currently held in free lists.
+    };
+
+    /**
+     * @param max_cached_bytes Upper bound on bytes kept in the free lists;
+     *                         beyond it, released blocks go back to the system.
+     */
+    explicit BufferPool(size_t max_cached_bytes = size_t(512) << 20, int numa_node = -1);
+    ~BufferPool();
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    /**
+     * @brief Returns the process‑wide pool.
+     */
+    static BufferPool &global();
+
+    /**
+     * @brief Returns the pool whose fresh blocks are bound to NUMA node `node`.
+     */
+    static BufferPool &for_node(int node);
+
+    /**
+     * @brief Returns the calling thread's pool (global() by default).
+     */
+    static BufferPool &local();
+
+    /**
+     * @brief Selects the calling thread's pool; nullptr restores global().
+     */
+    static void set_local(BufferPool *pool);
+
+    /**
+     * @brief Returns an uninitialized, 64‑byte aligned buffer of at least `bytes`.
+     * @throws std::bad_alloc if the system allocator fails.
+     */
+    void *allocate(size_t bytes);
+
+    /**
+     * @brief Returns a buffer to the pool that allocated it. Null is ignored.
+     */
+    void release(void *p);
+
+    /**
+     * @brief realloc() semantics on top of allocate()/release().
+     */
+    void *reallocate(void *p, size_t bytes);
+
+    /**
+     * @brief Frees every cached block.
+     */
+    void trim();
+
+    Stats stats() const;
+
+    /**
+     * @brief Selects the backing of blocks allocated from now on.
+     *
+     * Cached blocks keep their current backing until trimmed.
+     */
+    void set_huge_pages(HugePages policy);
+    HugePages huge_pages() const;
+
+    /**
+     * @brief Parses "off", "thp" or "explicit".
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static HugePages parse_huge_pages(const std::string &name);
+
+private:
+    struct Header;
+
+    static size_t class_index(size_t bytes);
+    static size_t class_bytes(size_t index);
+    Header *map_block(size_t index, HugePages policy);
+    static void free_block(Header *h);
+
+    mutable std::mutex mutex;
+    std::vector<std::vector<Header *>> free_lists;
+    size_t max_cached_bytes;
+    Stats counters;
+    HugePages policy = HugePages::Off;
+    int numa_node;
+};
+
+/**
+ * @brief std::allocator‑compatible adapter drawing from BufferPool::local().
+ */
+template <class T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <class U>
+    PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(BufferPool::local().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t) noexcept
+    {
+        BufferPool::local().release(p);
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U> &) const noexcept { return true; }
+};
+
+/// Byte vector whose storage comes from the thread's BufferPool.
+using PooledBytes = std::vector<unsigned char, PoolAllocator<unsigned char>>;
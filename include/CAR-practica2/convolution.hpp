@@ -1,5 +1,52 @@
 #pragma once
 #include "image.hpp"
+#include "half_image.hpp"
+#include <vector>
+
+/**
+ * @brief Evaluation strategies chosen by ConvolutionKernel::analyze().
+ */
+enum class KernelStrategy
+{
+    Direct,       ///< Nine float multiply‑adds (any kernel).
+    Sparse,       ///< Integer taps grouped by weight; zero taps skipped.
+    Separable,    ///< Integer row pass, then integer column pass.
+    BoxPlusCenter ///< a × (3×3 box sum) + (c − a) × centre, box sums shared by rows.
+};
+
+/**
+ * @brief Structure of a 3×3 kernel and the cheapest way to evaluate it.
+ *
+ * When every weight is n / 2^shift with small integers n, apply_linear() only
+ * ever adds exact products, so its float sum equals the integer sum
+ * S = Σ n · p scaled by 2^−shift. Any evaluation order then gives the same
+ * bytes: max(S, 0) >> shift, saturated to 255. The integer strategies rely on
+ * this; other kernels are evaluated directly.
+ */
+struct KernelAnalysis
+{
+    int zero_taps = 0;                  ///< Taps with weight 0.
+    int distinct_weights = 0;           ///< Distinct non‑zero weights.
+    bool symmetric_horizontal = false;  ///< w[y][x] == w[y][2 − x].
+    bool symmetric_vertical = false;    ///< w[y][x] == w[2 − y][x].
+    bool symmetric_point = false;       ///< w[y][x] == w[2 − y][2 − x].
+    bool separable = false;             ///< Rank one: w = column ⊗ row.
+    bool box_plus_center = false;       ///< The eight neighbours share one weight.
+
+    bool exact_integer = false; ///< Weights are n / 2^shift with exact float sums.
+    int shift = 0;
+    int weights[3][3] = {};     ///< The integers n (when exact_integer).
+    int column[3] = {};         ///< Integer factors, column[y] · row[x] = n
+    int row[3] = {};            ///  (when Separable was chosen).
+
+    KernelStrategy strategy = KernelStrategy::Direct;
+    int cost = 0; ///< Estimated adds and multiplies per output byte.
+
+    /**
+     * @brief Returns a short name for a strategy (e.g. "box-plus-center").
+     */
+    static const char *strategy_name(KernelStrategy strategy);
+};
 
 /**
  * @brief Represents a fixed 3×3 convolution kernel.
@@ -17,6 +64,39 @@ public:
      * @param init  Three rows of three floats each, in row‑major order.
      */
     ConvolutionKernel(std::initializer_list<std::initializer_list<float>> init);
+
+    /**
+     * @brief Detects zero taps, repeated weights, symmetry, separability and
+     *        box‑plus‑centre structure, and picks the cheapest strategy.
+     */
+    KernelAnalysis analyze() const;
+};
+
+/**
+ * @brief Convolution implementations selectable at run time.
+ */
+enum class Backend
+{
+    Linear,    ///< Scalar reference implementation (`apply_linear`).
+    Simd,       ///< SSE implementation, 4 RGB pixels at a time (`apply_simd`).
+    SimdGather, ///< Previous `apply_simd` load stage (scalar gathers), for comparison.
+    ByteStream, ///< Any channel count, 16/32/64 bytes per step (`apply_byte_stream`).
+    Blocked,    ///< Byte stream computing 2–4 output rows per pass (`apply_blocked`).
+    Fma,        ///< Byte stream with fused multiply‑add, AVX2 + FMA3 (`apply_fma`).
+    Algebraic,  ///< Strategy picked by ConvolutionKernel::analyze() (`apply_algebraic`).
+    Static,     ///< Compile‑time specialized kernels from static_kernel.hpp (`apply_static`).
+    Jit,        ///< AVX2 code generated per kernel at run time by KernelJit (`apply_jit`).
+    Winograd    ///< Winograd F(2×2, 3×3) minimal filtering (`apply_winograd`).
+};
+
+/**
+ * @brief How whole‑frame convolutions write their output rows.
+ */
+enum class StoreMode
+{
+    Auto,     ///< Streaming when input plus output exceed the last‑level cache.
+    Cached,   ///< Regular stores straight into the destination rows.
+    Streaming ///< Rows built in a line buffer, then written with non‑temporal stores.
 };
 
 /**
@@ -32,6 +112,32 @@ struct ConvolutionResult
     double elapsed_seconds;
 };
 
+/**
+ * @brief Two equally sized images used alternately as source and destination.
+ *
+ * Iterative filters read front() and write back(), then swap(); after the
+ * first pass both buffers are sized and no further allocation happens.
+ */
+class DoubleBuffer
+{
+public:
+    /**
+     * @param initial Starting image; becomes front(). back() is sized lazily.
+     */
+    explicit DoubleBuffer(Image initial) : buffers{std::move(initial), Image()} {}
+
+    Image &front() { return buffers[current]; }
+    const Image &front() const { return buffers[current]; }
+    Image &back() { return buffers[1 - current]; }
+
+    /// Makes the last written buffer the new front.
+    void swap() { current = 1 - current; }
+
+private:
+    Image buffers[2];
+    int current = 0;
+};
+
 class Convolver
 {
 public:
@@ -43,8 +149,133 @@ public:
      */
     static Image apply_linear(const Image &img, const ConvolutionKernel &kernel);
 
+    /**
+     * @brief View‑to‑view scalar convolution (no allocation, no copies).
+     *
+     * Computes every interior pixel of `out` (all but the outermost ring of the
+     * view) from the matching 3×3 neighbourhood of `img`. The outer ring of
+     * `out` is left untouched, so convolving a region of interest with one
+     * pixel of context is done by passing views that include that context.
+     *
+     * @param img     Source view.
+     * @param out     Destination view, same size and channel count; must not
+     *                overlap `img`.
+     * @param kernel  Convolution kernel to apply.
+     * @throws std::runtime_error if the views differ in size or channels.
+     */
+    static void apply_linear(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
     Image apply_simd(const Image &img, const ConvolutionKernel &kernel);
 
+    /**
+     * @brief View‑to‑view SIMD convolution; same contract as the view
+     *        overload of apply_linear(). Writes stay inside `out`.
+     *
+     * The vector code is specific to 3 channels; gray and RGBA images are
+     * handed to apply_byte_stream().
+     */
+    void apply_simd(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Channel‑agnostic SIMD convolution over each row as a byte stream.
+     *
+     * Horizontal neighbours are ±nChannels bytes apart, so the same code
+     * handles 1–4 channels. Processes 64 (AVX‑512), 32 (AVX2) or 16 (SSE4.1)
+     * bytes per step, chosen at run time; results are identical to
+     * apply_linear(). Same view contract as apply_linear().
+     */
+    static void apply_byte_stream(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Register‑blocked variant of apply_byte_stream().
+     *
+     * Computes several output rows per pass over a sliding window of input
+     * rows, so each input row is loaded once per horizontal tap instead of
+     * once per output row that uses it. The block factor follows the ISA:
+     * 4 rows with AVX2 / AVX‑512, 2 with SSE4.1. Same contract and results
+     * as apply_linear().
+     */
+    static void apply_blocked(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Byte‑stream convolution accumulating with `_mm256_fmadd_ps`.
+     *
+     * The nine weights are broadcast once per call and kept in registers.
+     * Requires AVX2 and FMA3 at run time; other CPUs get apply_byte_stream().
+     * Not bit‑exact: each tap rounds once instead of twice, so results may
+     * differ from apply_linear() by one level (see bit_exact()).
+     */
+    static void apply_fma(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Evaluates the kernel with the strategy from ConvolutionKernel::analyze().
+     *
+     * Integer (and n / 2^k) kernels are computed in 16‑ or 32‑bit integers:
+     * zero taps are skipped, taps sharing a weight are summed before one
+     * multiply, ±1 weights become adds and subtracts, separable kernels take a
+     * row pass and a column pass, and box‑plus‑centre kernels (such as the edge
+     * filter) reuse each input row's box sums for three output rows. Other
+     * kernels go to apply_blocked(). Same contract and results as apply_linear().
+     */
+    static void apply_algebraic(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Uses the StaticConvolution specialization compiled for `kernel`
+     *        (edge, sharpen or blur from static_kernel.hpp) when its weights
+     *        match exactly, and apply_blocked() otherwise. Same contract and
+     *        results as apply_linear().
+     */
+    static void apply_static(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Whether apply_static() has a compile‑time specialization for `kernel`.
+     */
+    static bool has_static_kernel(const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Runs a row loop generated for `kernel` by KernelJit (jit.hpp):
+     *        zero taps dropped, ±1 weights as adds and subtracts, the other
+     *        weights broadcast once. Falls back to apply_blocked() without
+     *        AVX2 or executable memory. Same contract and results as
+     *        apply_linear().
+     */
+    static void apply_jit(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Winograd F(2×2, 3×3): the kernel is transformed once and each 2×2
+     *        output tile takes 16 multiplies instead of 36, which pays off for
+     *        dense float kernels that apply_algebraic() cannot simplify.
+     *        Not bit‑exact: the reordered float sums may move a result by one
+     *        level from apply_linear() (see bit_exact()).
+     */
+    static void apply_winograd(ConstImageView img, ImageView out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Bytes per step the byte‑stream kernel can use on this CPU, ascending.
+     */
+    static std::vector<int> byte_stream_bytes_supported();
+
+    /**
+     * @brief Forces the byte‑stream step (16, 32 or 64); 0 restores the widest.
+     * @return false, leaving the setting unchanged, if the CPU lacks support.
+     */
+    static bool set_byte_stream_bytes(int bytes);
+
+    /**
+     * @brief Forces the vector width of the register‑blocked kernels: 16
+     *        (SSE4.1), 32 (AVX2) or 64 (AVX‑512) bytes; 0 restores the widest.
+     *        The CPU supports the widths in byte_stream_bytes_supported().
+     * @return false, leaving the setting unchanged, if the CPU lacks support.
+     */
+    static bool set_blocked_vector_bytes(int bytes);
+
+    /**
+     * @brief Validates the views of a view‑to‑view convolution.
+     * @throws std::runtime_error if they differ in size or channels, or the
+     *         channel count is outside 1–4.
+     */
+    static void check_views(ConstImageView img, ImageView out);
+
     /**
      * @brief Apply a convolution kernel to an image using either SIMD or scalar code.
      *
@@ -66,4 +297,141 @@ public:
     ConvolutionResult do_convolve(const Image &img,
                                   const ConvolutionKernel &kernel,
                                   bool use_simd);
+
+    /**
+     * @brief Apply a convolution kernel using an explicitly chosen backend.
+     * @param img      Input image to be convolved.
+     * @param kernel   3×3 convolution kernel.
+     * @param backend  Implementation to use.
+     * @return The convolution result and the time spent in the backend.
+     */
+    ConvolutionResult do_convolve(const Image &img,
+                                  const ConvolutionKernel &kernel,
+                                  Backend backend);
+
+    /**
+     * @brief Convolve into a caller‑provided image.
+     *
+     * `out` is reshaped to the size of `img` (Image::reshape()), which only
+     * allocates if its buffer is too small, so reusing the same `out` for a
+     * stream of frames runs without allocating.
+     *
+     * @param img      Input image.
+     * @param out      Destination; must not be `img`.
+     * @param kernel   3×3 convolution kernel.
+     * @param backend  Implementation to use.
+     * @return Seconds spent, including the border clear.
+     */
+    double do_convolve(const Image &img, Image &out,
+                       const ConvolutionKernel &kernel, Backend backend);
+
+    /**
+     * @brief Convolve into a caller‑provided view of the same size.
+     *
+     * Only the interior of `out` is written (see apply_linear()).
+     * @return Seconds spent in the backend.
+     * @throws std::runtime_error if the views differ in size or channels.
+     */
+    double do_convolve(ConstImageView img, ImageView out,
+                       const ConvolutionKernel &kernel, Backend backend);
+
+    /**
+     * @brief Convolves an image in place.
+     *
+     * Only the two original rows that are still needed (K − 1 for a 3×3
+     * kernel) are kept in a line buffer, so the extra memory is two padded
+     * rows instead of a second frame. The result is identical to the
+     * out‑of‑place backends, including the zeroed border.
+     *
+     * @param img      Image to overwrite with the filtered result.
+     * @param kernel   3×3 convolution kernel.
+     * @param backend  Implementation used for each row.
+     */
+    void apply_in_place(Image &img, const ConvolutionKernel &kernel, Backend backend);
+
+    /**
+     * @brief In‑place convolution of a view; like the view overloads of
+     *        apply_linear(), the outer ring of the view is left untouched.
+     */
+    void apply_in_place(ImageView img, const ConvolutionKernel &kernel, Backend backend);
+
+    /**
+     * @brief Convolves a half‑precision image into another, for chained filters.
+     *
+     * Accumulates in float32 in the same tap order as apply_linear() and
+     * stores the unclamped sum rounded to half precision, so intermediate
+     * stages keep negative and fractional values. Uses F16C (8 values per
+     * step) when available and scalar conversions otherwise, with identical
+     * results. `out` is reshaped and its border set to zero.
+     *
+     * @param img     Input image.
+     * @param out     Destination; must not be `img`.
+     * @param kernel  3×3 convolution kernel.
+     * @throws std::runtime_error for unsupported channel counts.
+     */
+    static void apply_half(const HalfImage &img, HalfImage &out, const ConvolutionKernel &kernel);
+
+    /**
+     * @brief Applies `kernel` `passes` times, ping‑ponging between the two
+     *        buffers. The final result is `buffers.front()`.
+     * @return Total seconds spent convolving.
+     */
+    double iterate(DoubleBuffer &buffers, const ConvolutionKernel &kernel,
+                   int passes, Backend backend);
+
+    /**
+     * @brief Selects how do_convolve(const Image&, Image&, ...) writes rows.
+     *
+     * In streaming mode each output row is computed into a cache‑resident line
+     * buffer and copied out with `_mm_stream_si128`, so the output does not
+     * evict input rows that the next rows still need; the input row two ahead
+     * is prefetched meanwhile. Views always use regular stores, because a
+     * streamed row also overwrites the border pixels and the row padding.
+     */
+    void set_store_mode(StoreMode mode) { stores = mode; }
+    StoreMode store_mode() const { return stores; }
+
+    /**
+     * @brief Size of the last‑level data cache in bytes (sysconf, then
+     *        /sys/devices/system/cpu; 8 MiB if neither reports it).
+     */
+    static size_t last_level_cache_bytes();
+
+    /**
+     * @brief Parses "auto", "cached" or "streaming".
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static StoreMode parse_store_mode(const std::string &name);
+
+    /**
+     * @brief Returns the command‑line name of a backend (e.g. "simd").
+     */
+    static const char *backend_name(Backend backend);
+
+    /**
+     * @brief Parses a backend name as returned by backend_name().
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static Backend parse_backend(const std::string &name);
+
+    /**
+     * @brief Lists every backend compiled into this binary.
+     */
+    static std::vector<Backend> backends();
+
+    /**
+     * @brief Whether a backend always reproduces apply_linear() bit for bit.
+     */
+    static bool bit_exact(Backend backend);
+
+private:
+    /**
+     * @param whole_rows `out` covers complete image rows, so streaming stores
+     *                   may also write its border pixels and row padding.
+     */
+    void run_backend(ConstImageView img, ImageView out,
+                     const ConvolutionKernel &kernel, Backend backend,
+                     bool whole_rows = false);
+
+    StoreMode stores = StoreMode::Auto;
 };
@@ -0,0 +1,56 @@
+#pragma once
+#include <complex>
+#include <vector>
+
+/**
+ * @brief Iterative radix‑2 FFT of one power‑of‑two size, in single precision.
+ *
+ * Twiddle factors and the bit‑reversal permutation are computed once per
+ * instance (in double, then rounded). transform_2d() works on square n × n
+ * row‑major arrays: all columns are transformed at once by running each
+ * butterfly across whole rows, and the rows as columns of the transpose, so
+ * both passes stream through memory and vectorize.
+ *
+ * Real signals are handled by packing two of them into one complex array
+ * (real and imaginary parts): filtering by the spectrum of a real kernel keeps
+ * the two results apart, so one complex transform serves two real inputs.
+ */
+class Fft
+{
+public:
+    using Complex = std::complex<float>;
+
+    /**
+     * @param size Transform length; must be a power of two.
+     * @throws std::runtime_error otherwise.
+     */
+    explicit Fft(int size);
+
+    int size() const { return n; }
+
+    /**
+     * @brief In‑place transform of `size()` values. The inverse is scaled by
+     *        1 / size(), so forward then inverse restores the input.
+     */
+    void transform(Complex *data, bool inverse) const;
+
+    /**
+     * @brief In‑place transform of a size() × size() row‑major array; the
+     *        inverse is scaled by 1 / size()².
+     */
+    void transform_2d(Complex *data, bool inverse) const;
+
+    static bool is_power_of_two(int n) { return n > 0 && (n & (n - 1)) == 0; }
+
+    /// Smallest power of two ≥ n (n ≥ 1).
+    static int next_power_of_two(int n);
+
+private:
+    void columns(Complex *data, bool inverse) const;
+    void transpose(Complex *data) const;
+
+    int n;
+    int log2n = 0;
+    std::vector<Complex> twiddles; ///< exp(−2πik / n), k < n / 2.
+    std::vector<int> reversed;     ///< Bit‑reversed index of each position.
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include "image.hpp"
+#include <cstdint>
+
+/**
+ * @brief Image storing one IEEE 754 half‑precision float per channel.
+ *
+ * Intermediate format for chained filters: unlike an 8‑bit Image it keeps
+ * negative values, fractions and values above 255 (11 significant bits) between
+ * stages, at half the memory traffic of float32. Values are converted with F16C
+ * (`_mm_cvtph_ps` / `_mm_cvtps_ph`) when the CPU supports it and with a scalar
+ * routine giving identical results otherwise.
+ */
+class HalfImage
+{
+public:
+    /// Rows start on a 64‑byte boundary (32 elements).
+    static constexpr int kRowAlignment = 32;
+
+    int width = 0, height = 0, nChannels = 0;
+    int stride = 0;   ///< Elements (not bytes) from the start of one row to the next.
+    PixelBuffer data; ///< 64‑byte aligned storage of uint16_t half floats.
+
+    HalfImage() = default;
+
+    /**
+     * @brief Constructs an image with uninitialized pixels.
+     */
+    HalfImage(int width, int height, int channels);
+
+    /**
+     * @brief Changes the dimensions, reusing the buffer when it is large enough.
+     */
+    void reshape(int width, int height, int channels);
+
+    /**
+     * @brief Returns the padded row stride, in elements, for the given width.
+     */
+    static int stride_for(int width, int channels);
+
+    uint16_t *row(int y) { return reinterpret_cast<uint16_t *>(data.data()) + size_t(y) * stride; }
+    const uint16_t *row(int y) const { return reinterpret_cast<const uint16_t *>(data.data()) + size_t(y) * stride; }
+
+    float get(int x, int y, int channel) const;
+    void set(int x, int y, int channel, float value);
+
+    /**
+     * @brief Converts an 8‑bit image (exactly; every byte value is a half).
+     */
+    static HalfImage from_image(const Image &img);
+
+    /**
+     * @brief Writes the pixels back as bytes, clamped to [0, 255] and
+     *        truncated like the 8‑bit backends. `out` is reshaped.
+     */
+    void to_image(Image &out) const;
+
+    /**
+     * @brief Whether the CPU supports F16C (and the AVX it is encoded with).
+     */
+    static bool f16c_supported();
+
+    /**
+     * @brief Converts `n` halves to floats.
+     */
+    static void to_float(const uint16_t *src, float *dst, size_t n);
+
+    /**
+     * @brief Converts `n` floats to halves, rounding to nearest even.
+     */
+    static void from_float(const float *src, uint16_t *dst, size_t n);
+
+    /// Scalar conversions; bit‑identical to the F16C instructions.
+    static float half_to_float(uint16_t h);
+    static uint16_t float_to_half(float f);
+};
@@ -3,22 +3,108 @@
 #include <string>
 #include <stdexcept>
 #include <algorithm>
+#include "pixel_buffer.hpp"
+
+/**
+ * @brief Non‑owning, strided view of pixels (a whole Image or a region of it).
+ *
+ * Views are cheap to copy and never allocate; crops, tiles and positions in
+ * a larger canvas are just different (data, width, height) over the same
+ * stride. The referenced Image must outlive the view.
+ */
+struct ImageView
+{
+    unsigned char *data = nullptr; ///< First byte of pixel (0, 0) of the view.
+    int width = 0, height = 0;
+    int stride = 0; ///< Bytes between consecutive rows.
+    int nChannels = 0;
+
+    unsigned char *row(int y) const { return data + size_t(y) * stride; }
+    unsigned char *pixel(int x, int y) const { return row(y) + x * nChannels; }
+};
+
+/**
+ * @brief Read‑only counterpart of ImageView.
+ */
+struct ConstImageView
+{
+    const unsigned char *data = nullptr;
+    int width = 0, height = 0;
+    int stride = 0;
+    int nChannels = 0;
+
+    ConstImageView() = default;
+    ConstImageView(const unsigned char *data, int width, int height, int stride, int nChannels)
+        : data(data), width(width), height(height), stride(stride), nChannels(nChannels) {}
+    ConstImageView(const ImageView &v)
+        : data(v.data), width(v.width), height(v.height), stride(v.stride), nChannels(v.nChannels) {}
+
+    const unsigned char *row(int y) const { return data + size_t(y) * stride; }
+    const unsigned char *pixel(int x, int y) const { return row(y) + x * nChannels; }
+};
 
 class Image
 {
 public:
+    /// Rows start on this boundary (one cache line).
+    static constexpr int kRowAlignment = 64;
+    /// Minimum readable bytes past the last pixel of every row, so vector
+    /// loads starting at the last pixels never leave the allocation.
+    static constexpr int kRowSlack = 32;
+
     int width = 0, height = 0, nChannels = 0;
-    std::vector<unsigned char> data;
+    int stride = 0;   ///< Bytes from the start of one row to the next (≥ width × nChannels + kRowSlack).
+    PixelBuffer data; ///< 64‑byte aligned pixel storage, recycled through BufferPool::local().
 
-    Image() : width(0), height(0), nChannels(0), data() {};
+    Image() : width(0), height(0), nChannels(0), stride(0), data() {};
     /**
-     * @brief Constructs an empty image with the given dimensions.
+     * @brief Constructs an image with the given dimensions.
+     *
+     * Rows are padded to a multiple of kRowAlignment with at least kRowSlack
+     * bytes of slack. The pixels (and padding) are left uninitialized; every
+     * writer (loader, generator, convolution backends) fills all pixels.
      * @param width   Image width in pixels.
      * @param height  Image height in pixels.
      * @param channels Number of color channels per pixel.
      */
     Image(int width, int height, int channels);
 
+    /**
+     * @brief Changes the dimensions, reusing the pixel buffer when it is
+     *        large enough. Pixel contents are unspecified afterwards.
+     */
+    void reshape(int width, int height, int channels);
+
+    /**
+     * @brief Returns the padded row stride used for the given row width.
+     */
+    static int stride_for(int width, int channels);
+
+    /**
+     * @brief Returns a pointer to the first byte of row `y`.
+     */
+    unsigned char *row(int y) { return data.data() + size_t(y) * stride; }
+    const unsigned char *row(int y) const { return data.data() + size_t(y) * stride; }
+
+    /**
+     * @brief Returns a view of the whole image.
+     */
+    ImageView view() { return {data.data(), width, height, stride, nChannels}; }
+    ConstImageView view() const { return {data.data(), width, height, stride, nChannels}; }
+
+    /**
+     * @brief Returns a view of the region [x, x + w) × [y, y + h).
+     * @throws std::out_of_range if the region is not inside the image.
+     */
+    ImageView view(int x, int y, int w, int h);
+    ConstImageView view(int x, int y, int w, int h) const;
+
+    /**
+     * @brief Copies the pixels into a tightly packed buffer (no row padding).
+     * @param dst Destination of width × height × nChannels bytes.
+     */
+    void copy_packed(unsigned char *dst) const;
+
     /**
      * @brief Returns the value of a specific pixel channel.
      * @param x       X‑coordinate of the pixel.
@@ -45,6 +131,12 @@ public:
      */
     static Image load(const std::string &path);
 
+    /**
+     * @brief Reads only the header of an image file (stbi_info).
+     * @return false if the file cannot be opened or the format is unknown.
+     */
+    static bool probe(const std::string &path, int &width, int &height, int &channels);
+
     /**
      * @brief Saves the image as a JPEG file.
      * @param path    Output file path.
@@ -59,7 +151,7 @@ private:
      * @param x       X‑coordinate of the pixel.
      * @param y       Y‑coordinate of the pixel.
      * @param channel Channel index.
-     * @return The corresponding 1D index into the data vector.
+     * @return The corresponding 1D index into the (row‑padded) data buffer.
      */
-    int index(int x, int y, int channel) const;
+    size_t index(int x, int y, int channel) const;
 };
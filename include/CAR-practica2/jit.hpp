@@ -0,0 +1,60 @@
+#pragma once
+#include "convolution.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Generates AVX2 machine code specialized for one runtime kernel.
+ *
+ * For kernels loaded at run time, where StaticConvolution cannot help, the
+ * row loop is emitted as x86‑64 code: zero taps are dropped, ±1 weights
+ * become vaddps / vsubps, and the other weights are broadcast once into
+ * registers before the loop. The horizontal tap offsets (±nChannels) are
+ * encoded as displacements, so code is generated per kernel and channel
+ * count. Each iteration converts 32 bytes with four accumulators, in the tap
+ * order of apply_linear() and with separate multiplies and adds, so the
+ * results are bit‑identical to it.
+ *
+ * Code is written to an mmap'd buffer that is then made read‑only and
+ * executable, and cached by kernel weights and channel count for the life of
+ * the process.
+ */
+class KernelJit
+{
+public:
+    /**
+     * @brief Generated row loop.
+     *
+     * Computes `blocks` consecutive 32‑byte blocks of one output row. The row
+     * pointers (y − 1, y, y + 1) and `out` point at the first byte to compute.
+     */
+    using RowFunction = void (*)(const unsigned char *above, const unsigned char *row,
+                                 const unsigned char *below, unsigned char *out, long blocks);
+
+    /// Bytes computed per loop iteration.
+    static constexpr int kBlockBytes = 32;
+
+    /**
+     * @brief Whether code can be generated and run here (x86‑64 with AVX2).
+     */
+    static bool supported();
+
+    /**
+     * @brief Returns the cached row loop for `kernel` and `nChannels`,
+     *        generating it on first use.
+     * @return nullptr if unsupported or if executable memory is unavailable.
+     */
+    static RowFunction compile(const ConvolutionKernel &kernel, int nChannels);
+
+    /**
+     * @brief Machine code that compile() would map, constants included
+     *        (for inspection; e.g. `objdump -D -b binary -m i386:x86-64`).
+     */
+    static std::vector<uint8_t> emit(const ConvolutionKernel &kernel, int nChannels);
+
+    /**
+     * @brief Number of row loops generated so far.
+     */
+    static size_t cached();
+};
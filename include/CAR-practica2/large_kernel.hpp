@@ -0,0 +1,133 @@
+#pragma once
+#include "convolution.hpp"
+#include "image.hpp"
+#include <vector>
+
+/**
+ * @brief Convolution kernel of any odd width and height.
+ *
+ * Weights are applied like ConvolutionKernel's: output (x, y) is the sum of
+ * weight(i, j) × input(x + i − rx, y + j − ry), clamped to [0, 255] and
+ * truncated, for the pixels where the whole kernel fits; the rx‑ and
+ * ry‑pixel border is set to zero.
+ */
+class LargeKernel
+{
+public:
+    int width = 0, height = 0;
+    std::vector<float> weights; ///< Row‑major, width × height.
+
+    /**
+     * @brief Kernel of the given size with all weights zero.
+     * @throws std::runtime_error unless both sizes are odd and positive.
+     */
+    LargeKernel(int width, int height);
+
+    /**
+     * @brief The same weights as a 3×3 kernel.
+     */
+    explicit LargeKernel(const ConvolutionKernel &kernel);
+
+    float &at(int x, int y) { return weights[size_t(y) * width + x]; }
+    float at(int x, int y) const { return weights[size_t(y) * width + x]; }
+
+    int radius_x() const { return width / 2; }
+    int radius_y() const { return height / 2; }
+
+    /// Non‑zero weights, the taps the direct method evaluates.
+    int taps() const;
+
+    /**
+     * @brief Normalized Gaussian of size (2 radius + 1)².
+     */
+    static LargeKernel gaussian(int radius, float sigma);
+
+    /**
+     * @brief Unsharp mask (1 + amount) δ − amount · gaussian(radius, sigma),
+     *        a simple deconvolution of a Gaussian blur.
+     */
+    static LargeKernel unsharp(int radius, float sigma, float amount);
+};
+
+/**
+ * @brief How LargeConvolver::apply() evaluates a kernel.
+ */
+enum class LargeMethod
+{
+    Auto,   ///< Cheaper of the two by the calibrated cost model.
+    Direct, ///< One multiply‑add per tap and output (`apply_direct`).
+    Fft     ///< Overlap‑add FFT convolution (`apply_fft`).
+};
+
+/**
+ * @brief Convolution with LargeKernel: direct for small kernels, FFT for
+ *        large ones.
+ *
+ * The direct method costs one multiply‑add per non‑zero tap and output value,
+ * so it grows with the kernel area. The FFT method cuts the image into blocks,
+ * zero‑pads each to a T × T tile (T a power of two, at least block + kernel − 1),
+ * multiplies its spectrum by the kernel's and adds the inverse back into the
+ * output (overlap‑add); its cost per pixel grows only with log T. Two blocks
+ * share one complex transform as its real and imaginary parts.
+ *
+ * apply() picks the method from a cost model with one measured constant per
+ * method (nanoseconds per tap, nanoseconds per FFT butterfly point). The
+ * defaults were measured on the development machine; calibrate() re‑measures
+ * them on the current one.
+ */
+class LargeConvolver
+{
+public:
+    /// Measured cost constants of the two methods.
+    struct CostModel
+    {
+        double direct_ns_per_tap;  ///< Per non‑zero tap and output value.
+        double fft_ns_per_point;   ///< Per tile point and radix‑2 stage, forward plus inverse.
+    };
+
+    /**
+     * @brief Convolves `img` into `out` (same size and channels, 1–4).
+     * @throws std::runtime_error if the views differ or the channel count is unsupported.
+     */
+    static void apply(ConstImageView img, ImageView out, const LargeKernel &kernel,
+                      LargeMethod method = LargeMethod::Auto);
+
+    /**
+     * @brief Direct evaluation, taps in row‑major order like apply_linear();
+     *        for a 3×3 kernel the results are identical to it.
+     */
+    static void apply_direct(ConstImageView img, ImageView out, const LargeKernel &kernel);
+
+    /**
+     * @brief Overlap‑add FFT convolution in single precision. Rounding may
+     *        move a result by one level from apply_direct().
+     */
+    static void apply_fft(ConstImageView img, ImageView out, const LargeKernel &kernel);
+
+    /**
+     * @brief Method apply() uses for this kernel and image size.
+     */
+    static LargeMethod choose(const LargeKernel &kernel, int width, int height, int nChannels);
+
+    /**
+     * @brief Tile size apply_fft() uses: the power of two with the least
+     *        transform work per output pixel.
+     */
+    static int fft_tile_size(const LargeKernel &kernel, int width, int height);
+
+    /**
+     * @brief Smallest odd size n for which a dense n × n kernel goes to the
+     *        FFT at this image size; 0 if none does.
+     */
+    static int crossover(int width, int height, int nChannels);
+
+    static CostModel cost_model();
+
+    /**
+     * @brief Times both methods on a synthetic frame and installs the
+     *        measured constants. Not synchronized with concurrent apply().
+     */
+    static CostModel calibrate();
+
+    static const char *method_name(LargeMethod method);
+};
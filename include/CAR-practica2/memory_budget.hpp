@@ -0,0 +1,88 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+
+/**
+ * @brief Bounds the pixel memory held by images in flight at once.
+ *
+ * Before an image is loaded its decoded size (known from the file header,
+ * see Image::probe()) is charged with acquire(); the charge is returned when
+ * the image and its output are released. While the budget is exhausted,
+ * acquire() blocks. Requests that fit may overtake a larger waiting one, so
+ * small images keep the workers busy, but only kMaxOvertakes times in a row
+ * before the oldest waiter is served. A single request larger than the whole
+ * budget is admitted once nothing else is in flight, so it cannot deadlock.
+ */
+class MemoryBudget
+{
+public:
+    /// Admissions that may pass the oldest waiter before it gets priority.
+    static constexpr int kMaxOvertakes = 4;
+
+    /**
+     * @param limit_bytes Bytes that may be charged at once; 0 means unlimited.
+     */
+    explicit MemoryBudget(size_t limit_bytes);
+
+    MemoryBudget(const MemoryBudget &) = delete;
+    MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+    /**
+     * @brief Blocks until `bytes` can be charged, then charges them.
+     */
+    void acquire(size_t bytes);
+
+    /**
+     * @brief Returns a charge made by acquire().
+     */
+    void release(size_t bytes);
+
+    size_t limit() const { return limit_bytes; }
+    size_t in_use() const;
+    size_t peak() const;
+    /// Number of acquire() calls that had to wait.
+    uint64_t waits() const;
+
+    /**
+     * @brief Parses a byte count with an optional K, M or G suffix (powers of 1024).
+     * @throws std::runtime_error if the text is not a size.
+     */
+    static size_t parse_size(const std::string &text);
+
+private:
+    bool admissible(size_t bytes, uint64_t ticket) const;
+
+    const size_t limit_bytes;
+    mutable std::mutex mutex;
+    std::condition_variable released;
+    size_t used = 0;
+    size_t peak_used = 0;
+    uint64_t wait_count = 0;
+    uint64_t next_ticket = 0;
+    std::set<uint64_t> waiting; ///< Tickets of blocked requests, oldest first.
+    int overtakes = 0;          ///< Admissions that passed the oldest waiter.
+};
+
+/**
+ * @brief RAII charge against a MemoryBudget.
+ */
+class BudgetCharge
+{
+public:
+    BudgetCharge(MemoryBudget &budget, size_t bytes) : budget(budget), bytes(bytes)
+    {
+        budget.acquire(bytes);
+    }
+    ~BudgetCharge() { budget.release(bytes); }
+
+    BudgetCharge(const BudgetCharge &) = delete;
+    BudgetCharge &operator=(const BudgetCharge &) = delete;
+
+private:
+    MemoryBudget &budget;
+    size_t bytes;
+};
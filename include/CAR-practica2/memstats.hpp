@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Heap allocation counters gathered by the operator new/delete hooks.
+ */
+struct AllocationCounters
+{
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_freed = 0;
+
+    /// Counter deltas between two snapshots (`after - before`).
+    AllocationCounters operator-(const AllocationCounters &before) const
+    {
+        return {allocations - before.allocations,
+                deallocations - before.deallocations,
+                bytes_allocated - before.bytes_allocated,
+                bytes_freed - before.bytes_freed};
+    }
+};
+
+/**
+ * @brief Process memory accounting: allocation churn and resident set size.
+ *
+ * Allocation counting replaces the global operator new/delete and is only
+ * compiled in when `CAR_TRACK_ALLOCS` is defined (CMake option
+ * `CAR_ALLOC_STATS`). Without it, snapshot() returns zeros. The RSS queries
+ * always work on Linux.
+ *
+ * Note that allocations made with malloc directly (e.g. inside stb_image)
+ * are not counted; only C++ heap traffic is.
+ */
+class MemoryStats
+{
+public:
+    /**
+     * @brief Returns true if the operator new/delete hooks were compiled in.
+     */
+    static constexpr bool tracking_compiled_in()
+    {
+#ifdef CAR_TRACK_ALLOCS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Returns the current process‑wide allocation counters.
+     */
+    static AllocationCounters snapshot();
+
+    /**
+     * @brief Peak resident set size in KiB (`getrusage` ru_maxrss).
+     */
+    static long peak_rss_kb();
+
+    /**
+     * @brief Current resident set size in KiB (VmRSS from /proc/self/status),
+     *        or -1 if unavailable.
+     */
+    static long current_rss_kb();
+};
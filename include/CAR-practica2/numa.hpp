@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief One NUMA node and the CPUs that belong to it.
+ */
+struct NumaNode
+{
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+/**
+ * @brief NUMA topology queries and placement helpers.
+ *
+ * Uses /sys/devices/system/node and raw syscalls (sched_setaffinity, mbind)
+ * only, so it builds and runs where libnuma is not installed. On machines
+ * without NUMA information everything degrades to a single node holding
+ * every CPU the process may run on.
+ */
+class NumaTopology
+{
+public:
+    /**
+     * @brief Returns the online nodes that have CPUs, in id order.
+     */
+    static std::vector<NumaNode> detect();
+
+    /**
+     * @brief Restricts the calling thread to the CPUs of `node`.
+     * @return false if the affinity could not be set.
+     */
+    static bool pin_current_thread(const NumaNode &node);
+
+    /**
+     * @brief Binds the pages fully inside [p, p + bytes) to `node` (mbind).
+     *
+     * Pages not yet touched will be allocated on that node; pages already
+     * present are migrated. Best effort: returns false if the kernel refuses.
+     */
+    static bool bind_memory(void *p, size_t bytes, int node);
+};
+
+/**
+ * @brief Worker threads grouped per NUMA node.
+ *
+ * Jobs are distributed round‑robin over the nodes; each node's workers pull
+ * from that node's share only, so an image is loaded, convolved and written
+ * by threads of one node. With pinning enabled each worker is restricted to
+ * its node's CPUs and allocates pixel buffers from a per‑node BufferPool
+ * whose fresh blocks are mbind'ed to the node; recycled blocks therefore
+ * stay node‑local too.
+ */
+class NumaWorkerPool
+{
+public:
+    /**
+     * @param total_workers Number of threads, spread evenly over the nodes
+     *                      (at least one per node when NUMA‑aware).
+     * @param numa_aware    Pin workers and bind buffers per node; if false a
+     *                      single unpinned group is used.
+     */
+    NumaWorkerPool(int total_workers, bool numa_aware);
+
+    /**
+     * @brief Signature of a job: job index, worker index, node id.
+     */
+    using Job = std::function<void(size_t job, int worker, int node)>;
+
+    /**
+     * @brief Runs `fn` for every job in [0, n_jobs) and waits for completion.
+     *
+     * Exceptions escaping `fn` terminate the program; handle them inside.
+     */
+    void run(size_t n_jobs, const Job &fn);
+
+    int workers() const { return total_workers; }
+    const std::vector<NumaNode> &nodes() const { return groups; }
+
+private:
+    std::vector<NumaNode> groups;
+    std::vector<int> workers_per_group;
+    int total_workers;
+    bool numa_aware;
+};
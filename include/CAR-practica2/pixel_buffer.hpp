@@ -0,0 +1,66 @@
+#pragma once
+#include "buffer_pool.hpp"
+#include <cstring>
+#include <utility>
+
+/**
+ * @brief Owning, 64‑byte aligned pixel storage that is NOT zero‑filled.
+ *
+ * Replaces std::vector for Image pixels: a vector value‑initializes every
+ * byte even though the convolution immediately overwrites them, and gives
+ * no alignment guarantee beyond alignof(max_align_t). Memory comes from
+ * BufferPool::local(), so large frames are recycled and can be backed by
+ * huge pages (BufferPool::set_huge_pages()).
+ *
+ * Copying performs a deep copy; moving transfers ownership.
+ */
+class PixelBuffer
+{
+public:
+    PixelBuffer() = default;
+
+    /**
+     * @brief Allocates `size` uninitialized bytes.
+     */
+    explicit PixelBuffer(size_t size)
+        : ptr(size ? static_cast<unsigned char *>(BufferPool::local().allocate(size)) : nullptr),
+          length(size) {}
+
+    PixelBuffer(const PixelBuffer &other) : PixelBuffer(other.length)
+    {
+        if (length)
+            std::memcpy(ptr, other.ptr, length);
+    }
+
+    PixelBuffer(PixelBuffer &&other) noexcept
+        : ptr(std::exchange(other.ptr, nullptr)), length(std::exchange(other.length, 0)) {}
+
+    PixelBuffer &operator=(PixelBuffer other) noexcept
+    {
+        std::swap(ptr, other.ptr);
+        std::swap(length, other.length);
+        return *this;
+    }
+
+    ~PixelBuffer()
+    {
+        BufferPool::local().release(ptr);
+    }
+
+    unsigned char *data() { return ptr; }
+    const unsigned char *data() const { return ptr; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    unsigned char &operator[](size_t i) { return ptr[i]; }
+    const unsigned char &operator[](size_t i) const { return ptr[i]; }
+
+    unsigned char *begin() { return ptr; }
+    unsigned char *end() { return ptr + length; }
+    const unsigned char *begin() const { return ptr; }
+    const unsigned char *end() const { return ptr + length; }
+
+private:
+    unsigned char *ptr = nullptr;
+    size_t length = 0;
+};
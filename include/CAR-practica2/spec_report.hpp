@@ -0,0 +1,93 @@
+#pragma once
+#include "convolution.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One benchmark case of the convolution suite (backend × kernel × size).
+ */
+struct SpecCase
+{
+    std::string name; ///< "<backend>.<kernel>.<size>", e.g. "simd.edge.hd".
+    Backend backend;
+    std::string kernel_name;
+    int width, height;
+    int repetitions; ///< Convolutions timed together in one run.
+};
+
+/**
+ * @brief Timings of a single case: one entry per run.
+ */
+struct SpecCaseResult
+{
+    SpecCase spec;
+    std::vector<double> run_seconds;
+    double reference_seconds = 0; ///< 0 if the reference has no entry.
+
+    double median() const;
+    double best() const;
+};
+
+/**
+ * @brief SPEC CPU2000‑style benchmark report for the convolution workload.
+ *
+ * Runs every (backend × kernel × size) case on synthetic input a fixed
+ * number of times and compares the run times with the times of a stored
+ * reference machine. As in SPEC, ratio = 100 × reference / run time and the
+ * overall score is the geometric mean of the per‑case ratios.
+ *
+ * SPEC's base and peak come from two separately tuned builds; here both
+ * columns come from the same binary: base uses the median run (as SPEC
+ * selects the median of three) and peak uses the best run. Compare two
+ * builds by running the suite with each bench-* target.
+ */
+class SpecSuite
+{
+public:
+    /// Number of runs per case required for a "reportable" result.
+    static constexpr int kReportableRuns = 3;
+
+    /**
+     * @brief Returns the default list of cases.
+     */
+    static std::vector<SpecCase> default_cases();
+
+    /**
+     * @brief Runs every case `runs` times.
+     * @param cases Cases to run.
+     * @param runs  Runs per case (at least 1).
+     * @param log   If true, prints one progress line per case to stdout.
+     */
+    static std::vector<SpecCaseResult> run(const std::vector<SpecCase> &cases,
+                                           int runs, bool log = true);
+
+    /**
+     * @brief Reads a reference file ("# machine: ..." header, then
+     *        "<case> <seconds>" lines).
+     * @param path           Reference file path.
+     * @param machine_name   Receives the reference machine description.
+     * @return Map from case name to reference seconds.
+     * @throws std::runtime_error if the file cannot be read.
+     */
+    static std::map<std::string, double> load_reference(const std::string &path,
+                                                        std::string &machine_name);
+
+    /**
+     * @brief Writes the median run times as a new reference file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void save_reference(const std::string &path,
+                               const std::vector<SpecCaseResult> &results);
+
+    /**
+     * @brief Writes the SPEC‑style text report (.asc layout).
+     * @param path           Output path.
+     * @param results        Results with reference_seconds filled in.
+     * @param machine_name   Reference machine description.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void write_report(const std::string &path,
+                             const std::vector<SpecCaseResult> &results,
+                             const std::string &machine_name);
+};
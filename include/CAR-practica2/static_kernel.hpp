@@ -0,0 +1,283 @@
+#pragma once
+#include "convolution.hpp"
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+
+/**
+ * @brief 3×3 kernel known at compile time, usable as a template argument.
+ *
+ * StaticConvolution<K> is generated for one such kernel: zero taps emit no
+ * code, ±1 weights become plain adds and subtracts, and every other weight is
+ * a multiply by an immediate, all in straight‑line code.
+ */
+struct StaticKernel
+{
+    float data[3][3];
+
+    constexpr float weight(int tap) const { return data[tap / 3][tap % 3]; }
+
+    /// Index of the first non‑zero tap in reference order, 9 if there is none.
+    constexpr int first_tap() const
+    {
+        int tap = 0;
+        while (tap < 9 && weight(tap) == 0)
+            tap++;
+        return tap;
+    }
+
+    /// The same weights as a runtime kernel.
+    ConvolutionKernel runtime() const
+    {
+        return {{data[0][0], data[0][1], data[0][2]},
+                {data[1][0], data[1][1], data[1][2]},
+                {data[2][0], data[2][1], data[2][2]}};
+    }
+};
+
+/// Kernels used by the application and the benchmark suite.
+constexpr StaticKernel kEdgeKernel{{{-1, -1, -1}, {-1, 8, -1}, {-1, -1, -1}}};
+constexpr StaticKernel kSharpenKernel{{{0, -1, 0}, {-1, 5, -1}, {0, -1, 0}}};
+constexpr StaticKernel kBlurKernel{{{1 / 16.f, 2 / 16.f, 1 / 16.f},
+                                    {2 / 16.f, 4 / 16.f, 2 / 16.f},
+                                    {1 / 16.f, 2 / 16.f, 1 / 16.f}}};
+/// Gaussian with σ = 1: dense float weights that no integer strategy applies to.
+constexpr StaticKernel kGaussianKernel{{{0.0751136f, 0.123841f, 0.0751136f},
+                                        {0.123841f, 0.204180f, 0.123841f},
+                                        {0.0751136f, 0.123841f, 0.0751136f}}};
+
+/**
+ * Vector operations of the byte‑stream kernels, one struct per ISA. Each step
+ * covers 4 × lanes bytes: four float accumulators, converted and stored like
+ * bytestream_row_16/32/64 in convolution.cpp.
+ */
+struct StaticSse
+{
+    using Vec = __m128;
+    static constexpr int kBytes = 16;
+
+    static Vec zero() { return _mm_setzero_ps(); }
+    static Vec set1(float w) { return _mm_set1_ps(w); }
+    static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+
+    static Vec load(const unsigned char *p, int q)
+    {
+        int bytes;
+        std::memcpy(&bytes, p + 4 * q, sizeof(bytes));
+        return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+    }
+
+    static void store(unsigned char *out, const Vec acc[4])
+    {
+        __m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(acc[0]), _mm_cvttps_epi32(acc[1]));
+        __m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(acc[2]), _mm_cvttps_epi32(acc[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(lo, hi));
+    }
+};
+
+struct StaticAvx2
+{
+    using Vec = __m256;
+    static constexpr int kBytes = 32;
+
+    __attribute__((target("avx2"))) static Vec zero() { return _mm256_setzero_ps(); }
+    __attribute__((target("avx2"))) static Vec set1(float w) { return _mm256_set1_ps(w); }
+    __attribute__((target("avx2"))) static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    __attribute__((target("avx2"))) static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    __attribute__((target("avx2"))) static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+
+    __attribute__((target("avx2"))) static Vec load(const unsigned char *p, int q)
+    {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 8 * q));
+        return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+    }
+
+    __attribute__((target("avx2"))) static void store(unsigned char *out, const Vec acc[4])
+    {
+        // packs/packus work per 128‑bit lane; the permute restores byte order.
+        __m256i lo = _mm256_packs_epi32(_mm256_cvttps_epi32(acc[0]), _mm256_cvttps_epi32(acc[1]));
+        __m256i hi = _mm256_packs_epi32(_mm256_cvttps_epi32(acc[2]), _mm256_cvttps_epi32(acc[3]));
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi),
+                                                    _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), bytes);
+    }
+};
+
+// row_ops() is generic over the vector type and always inlined into the
+// target("avx2") / target("avx512f") callers; GCC still warns about the ABI
+// of its __m256 / __m512 locals, which never cross a call. GCC 12's
+// avx512fintrin.h also trips -Wmaybe-uninitialized on the _mm512_undefined_*
+// operands of the conversions once they are inlined here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+struct StaticAvx512
+{
+    using Vec = __m512;
+    static constexpr int kBytes = 64;
+
+    __attribute__((target("avx512f"))) static Vec zero() { return _mm512_setzero_ps(); }
+    __attribute__((target("avx512f"))) static Vec set1(float w) { return _mm512_set1_ps(w); }
+    __attribute__((target("avx512f"))) static Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+    __attribute__((target("avx512f"))) static Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+    __attribute__((target("avx512f"))) static Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+
+    __attribute__((target("avx512f"))) static Vec load(const unsigned char *p, int q)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * q));
+        return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes));
+    }
+
+    __attribute__((target("avx512f"))) static void store(unsigned char *out, const Vec acc[4])
+    {
+        // max(·, 0) then unsigned saturating narrow = clamp to [0, 255].
+        for (int q = 0; q < 4; q++)
+        {
+            __m512i ints = _mm512_max_epi32(_mm512_cvttps_epi32(acc[q]), _mm512_setzero_si512());
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * q), _mm512_cvtusepi32_epi8(ints));
+        }
+    }
+};
+
+/**
+ * @brief Convolution specialized for one compile‑time kernel.
+ *
+ * Taps are expanded in the reference order (ky, then kx) and each one is
+ * resolved at compile time, so the result is bit‑identical to apply_linear():
+ * skipping p × 0 or turning acc + p × (±1) into acc ± p does not change any
+ * float sum, and the first non‑zero tap is assigned instead of added to zero,
+ * which can only differ in the sign of a zero that truncates to 0 anyway.
+ */
+template <StaticKernel K>
+class StaticConvolution
+{
+public:
+    /**
+     * @brief Interior pixels of one output row; matches the runtime row
+     *        kernels so it plugs into the same drivers (the runtime kernel
+     *        argument is ignored).
+     */
+    static void row(const unsigned char *const rows[3], unsigned char *out,
+                    int width, int nChannels, const ConvolutionKernel &)
+    {
+        static const int widest = __builtin_cpu_supports("avx512f") ? 64
+                                  : __builtin_cpu_supports("avx2")  ? 32
+                                                                    : 16;
+        const int begin = nChannels;
+        const int end = (width - 1) * nChannels;
+        if (widest >= 64 && end - begin >= 64)
+            row_avx512(rows, out, begin, end, nChannels);
+        else if (widest >= 32 && end - begin >= 32)
+            row_avx2(rows, out, begin, end, nChannels);
+        else if (end - begin >= 16)
+            row_ops<StaticSse>(rows, out, begin, end, nChannels);
+        else
+            row_scalar(rows, out, begin, end, nChannels);
+    }
+
+    /**
+     * @brief Same view contract as Convolver::apply_linear().
+     * @throws std::runtime_error if the views differ in size or channels.
+     */
+    static void apply(ConstImageView img, ImageView out)
+    {
+        Convolver::check_views(img, out);
+
+        const ConvolutionKernel kernel = K.runtime();
+        for (int y = 1; y < img.height - 1; y++)
+        {
+            const unsigned char *rows[3] = {img.row(y - 1), img.row(y), img.row(y + 1)};
+            row(rows, out.row(y), img.width, img.nChannels, kernel);
+        }
+    }
+
+private:
+    /// Adds taps T … 8 to the four accumulators; expands to straight‑line code.
+    template <typename Ops, int T = 0>
+    [[gnu::always_inline]] static void accumulate(typename Ops::Vec acc[4], const unsigned char *const rows[3],
+                                                  int i, int nChannels)
+    {
+        if constexpr (T < 9)
+        {
+            constexpr float w = K.weight(T);
+            if constexpr (w != 0)
+            {
+                const unsigned char *p = rows[T / 3] + i + (T % 3 - 1) * nChannels;
+                for (int q = 0; q < 4; q++)
+                {
+                    const typename Ops::Vec v = Ops::load(p, q);
+                    if constexpr (T == K.first_tap() && w == 1)
+                        acc[q] = v;
+                    else if constexpr (T == K.first_tap())
+                        acc[q] = Ops::mul(v, Ops::set1(w));
+                    else if constexpr (w == 1)
+                        acc[q] = Ops::add(acc[q], v);
+                    else if constexpr (w == -1)
+                        acc[q] = Ops::sub(acc[q], v);
+                    else
+                        acc[q] = Ops::add(acc[q], Ops::mul(v, Ops::set1(w)));
+                }
+            }
+            accumulate<Ops, T + 1>(acc, rows, i, nChannels);
+        }
+    }
+
+    template <typename Ops>
+    [[gnu::always_inline]] static void row_ops(const unsigned char *const rows[3], unsigned char *out,
+                                               int begin, int end, int nChannels)
+    {
+        // Shifted last block instead of a scalar tail, as in the runtime kernels.
+        for (int block = begin; block < end; block += Ops::kBytes)
+        {
+            const int i = std::min(block, end - Ops::kBytes);
+            typename Ops::Vec acc[4] = {Ops::zero(), Ops::zero(), Ops::zero(), Ops::zero()};
+            accumulate<Ops>(acc, rows, i, nChannels);
+            Ops::store(out + i, acc);
+        }
+    }
+
+    __attribute__((target("avx2"))) static void row_avx2(const unsigned char *const rows[3], unsigned char *out,
+                                                         int begin, int end, int nChannels)
+    {
+        row_ops<StaticAvx2>(rows, out, begin, end, nChannels);
+    }
+
+    __attribute__((target("avx512f"))) static void row_avx512(const unsigned char *const rows[3], unsigned char *out,
+                                                              int begin, int end, int nChannels)
+    {
+        row_ops<StaticAvx512>(rows, out, begin, end, nChannels);
+    }
+
+    template <int T = 0>
+    static void accumulate_scalar(float &acc, const unsigned char *const rows[3], int i, int nChannels)
+    {
+        if constexpr (T < 9)
+        {
+            constexpr float w = K.weight(T);
+            const float p = rows[T / 3][i + (T % 3 - 1) * nChannels];
+            if constexpr (w == 1)
+                acc += p;
+            else if constexpr (w == -1)
+                acc -= p;
+            else if constexpr (w != 0)
+                acc += p * w;
+            accumulate_scalar<T + 1>(acc, rows, i, nChannels);
+        }
+    }
+
+    static void row_scalar(const unsigned char *const rows[3], unsigned char *out,
+                           int begin, int end, int nChannels)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            float acc = 0;
+            accumulate_scalar(acc, rows, i, nChannels);
+            out[i] = std::clamp(acc, 0.0f, 255.0f);
+        }
+    }
+};
+
+#pragma GCC diagnostic pop
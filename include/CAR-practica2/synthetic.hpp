@@ -0,0 +1,52 @@
+#pragma once
+#include "image.hpp"
+#include <cstdint>
+
+/**
+ * @brief Families of procedurally generated test images.
+ */
+enum class SyntheticPattern
+{
+    Noise,    ///< Independent uniform noise per channel (worst case for caches/branches).
+    Gradient, ///< Smooth diagonal gradients with a different phase per channel.
+    Texture,  ///< Multi‑octave value noise with soft edges, close to a photograph.
+    Mixed     ///< Cycles through the patterns above, one per generated image.
+};
+
+/**
+ * @brief Deterministic, seeded image generator.
+ *
+ * Produces images of any size and channel count entirely in memory so that
+ * the driver and benchmarks can run on hosts that do not have the Kaggle
+ * dataset. The same (pattern, size, channels, seed) tuple always yields the
+ * same pixels on every platform: the generator uses its own integer PRNG
+ * instead of the implementation‑defined <random> distributions, and only
+ * correctly rounded float operations (no libm transcendentals).
+ */
+class SyntheticImage
+{
+public:
+    /**
+     * @brief Generates a single image.
+     * @param width    Image width in pixels.
+     * @param height   Image height in pixels.
+     * @param channels Number of color channels per pixel (1–4).
+     * @param pattern  Pattern family to draw.
+     * @param seed     Seed; different seeds give different images.
+     * @return A fully initialized Image object.
+     * @throws std::runtime_error if the dimensions are invalid.
+     */
+    static Image generate(int width, int height, int channels,
+                          SyntheticPattern pattern, uint64_t seed);
+
+    /**
+     * @brief Parses a pattern name ("noise", "gradient", "texture", "mixed").
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static SyntheticPattern parse_pattern(const std::string &name);
+
+    /**
+     * @brief Returns the canonical name of a pattern.
+     */
+    static const char *pattern_name(SyntheticPattern pattern);
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Optional Chrome trace‑event recorder.
+ *
+ * Records begin/end events per thread into fixed‑size per‑thread buffers and
+ * dumps them as Chrome `trace_event` JSON (open it in Perfetto or
+ * chrome://tracing).
+ *
+ * Recording is only compiled in when `CAR_ENABLE_TRACE` is defined (CMake
+ * option `CAR_TRACE`). Otherwise `CAR_TRACE_SCOPE` expands to nothing and the
+ * Tracer functions are empty stubs, so instrumented code costs nothing.
+ *
+ * Each thread only ever writes to its own buffer and publishes its event
+ * count with a release store, so recording never takes a lock. Buffers are
+ * registered once per thread in a lock‑free list and live until exit.
+ */
+class Tracer
+{
+public:
+    /// Maximum number of events kept per thread; later events are dropped.
+    static constexpr size_t kEventsPerThread = 1 << 16;
+
+    /**
+     * @brief Returns true if tracing support was compiled in.
+     */
+    static constexpr bool compiled_in()
+    {
+#ifdef CAR_ENABLE_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Starts recording events (no effect when compiled out).
+     */
+    static void start();
+
+    /**
+     * @brief Stops recording; already recorded events are kept.
+     */
+    static void stop();
+
+    /**
+     * @brief Names the calling thread in the dumped timeline.
+     * @param name Thread name; must outlive the tracer (string literal).
+     */
+    static void set_thread_name(const char *name);
+
+    /**
+     * @brief Records a begin or end event on the calling thread.
+     * @param name  Event name; must be a string literal.
+     * @param phase 'B' for begin, 'E' for end.
+     * @param arg   Optional integer argument (e.g. first row of a band), -1 for none.
+     */
+    static void record(const char *name, char phase, int64_t arg = -1);
+
+    /**
+     * @brief Writes all recorded events as Chrome trace‑event JSON.
+     * @param path Output file path.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void dump(const std::string &path);
+};
+
+#ifdef CAR_ENABLE_TRACE
+
+/**
+ * @brief RAII helper emitting a begin event on construction and an end
+ *        event on destruction.
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name, int64_t arg = -1) : name(name)
+    {
+        Tracer::record(name, 'B', arg);
+    }
+    ~TraceScope() { Tracer::record(name, 'E'); }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+};
+
+#define CAR_TRACE_CONCAT_(a, b) a##b
+#define CAR_TRACE_CONCAT(a, b) CAR_TRACE_CONCAT_(a, b)
+#define CAR_TRACE_SCOPE(...) TraceScope CAR_TRACE_CONCAT(car_trace_scope_, __LINE__)(__VA_ARGS__)
+
+#else
+
+#define CAR_TRACE_SCOPE(...) ((void)0)
+
+#endif
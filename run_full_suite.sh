@@ -1,25 +1,17 @@
 #!/bin/bash
+set -e
 
-echo "=== Compiling (-O0) ==="
-./auxiliary-compilation-scripts/compile_O0.sh
-echo
+# Builds every benchmark variant (O0, O2, O3, native, lto; no sanitizers) in
+# its own directory under build-bench/bench/ and runs each one scalar and SIMD.
+#
+# Extra arguments replace the default benchmark arguments, e.g.
+#   ./run_full_suite.sh --synthetic --images 50 --size 1920x1080
+# Without arguments the synthetic workload is used, so no dataset is needed.
 
-echo "=== Compiling (-O3) ==="
-./auxiliary-compilation-scripts/compile_O3.sh
-echo
+BENCH_ARGS="--synthetic;--images;20;--no-save"
+if [ $# -gt 0 ]; then
+    BENCH_ARGS=$(IFS=';'; echo "$*")
+fi
 
-echo "=== Running: scalar (-O0) ==="
-./main_O0 --nosimd
-echo
-
-echo "=== Running: SIMD (-O0) ==="
-./main_O0 --simd
-echo
-
-echo "=== Running: scalar (-O3) ==="
-./main_O3 --nosimd
-echo
-
-echo "=== Running: SIMD (-O3) ==="
-./main_O3 --simd
-echo
+cmake -S . -B build-bench -DCMAKE_BUILD_TYPE=Release "-DCAR_BENCH_ARGS=$BENCH_ARGS"
+cmake --build build-bench --target bench
@@ -2,11 +2,11 @@
 set -e
 
 CXX=g++
-CXXFLAGS="-O3 -march=native -Wall -Wextra"
+CXXFLAGS="-std=c++20 -O3 -march=native -ffp-contract=off -Wall -Wextra"
 INCLUDES="-Iinclude -Iinclude/CAR-practica2"
 LIBS="-lssl -lcrypto"
 
-SRC="src/convolution.cpp src/image.cpp test/test_hash_images.cpp"
+SRC="$(ls src/*.cpp | grep -v main.cpp) test/test_hash_images.cpp"
 OUT="hash_test"
 
 echo "Compiling..."
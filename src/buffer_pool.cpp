@@ -0,0 +1,256 @@
+#include <CAR-practica2/buffer_pool.hpp>
+#include <CAR-practica2/numa.hpp>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+
+namespace
+{
+    constexpr uint32_t kMagic = 0xB0FFE7u;
+}
+
+/// Sits in front of every block; padded so user data stays 64‑byte aligned.
+struct alignas(BufferPool::kAlignment) BufferPool::Header
+{
+    uint32_t magic;
+    uint32_t size_class;
+    size_t mapped_bytes; ///< Length of the mmap'd region, 0 for heap blocks.
+    BufferPool *owner;   ///< Pool the block returns to.
+};
+
+namespace
+{
+    thread_local BufferPool *thread_pool = nullptr;
+}
+
+BufferPool::BufferPool(size_t max_cached_bytes, int numa_node)
+    : max_cached_bytes(max_cached_bytes), numa_node(numa_node) {}
+
+BufferPool::~BufferPool()
+{
+    trim();
+}
+
+BufferPool &BufferPool::global()
+{
+    // Leaked on purpose: static Image objects may release buffers during exit.
+    static BufferPool *pool = new BufferPool();
+    return *pool;
+}
+
+BufferPool &BufferPool::for_node(int node)
+{
+    // Leaked like global(), map included, so buffers can be released at exit.
+    static std::mutex pools_mutex;
+    static auto *pools = new std::map<int, BufferPool *>();
+
+    std::lock_guard<std::mutex> lock(pools_mutex);
+    BufferPool *&pool = (*pools)[node];
+    if (!pool)
+        pool = new BufferPool(size_t(512) << 20, node);
+    return *pool;
+}
+
+BufferPool &BufferPool::local()
+{
+    return thread_pool ? *thread_pool : global();
+}
+
+void BufferPool::set_local(BufferPool *pool)
+{
+    thread_pool = pool;
+}
+
+size_t BufferPool::class_index(size_t bytes)
+{
+    if (bytes <= kMinClassBytes)
+        return 0;
+
+    // bytes lies in (2^(p-1), 2^p]; split that range into four steps.
+    const size_t p = 64 - __builtin_clzll(bytes - 1);
+    const size_t step = size_t(1) << (p - 3);
+    const size_t mult = (bytes + step - 1) / step; // 5..8
+    return (p - 13) * 4 + (mult - 4);
+}
+
+size_t BufferPool::class_bytes(size_t index)
+{
+    return (4 + index % 4) << (10 + index / 4);
+}
+
+void *BufferPool::allocate(size_t bytes)
+{
+    const size_t index = class_index(bytes);
+    Header *h = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index < free_lists.size() && !free_lists[index].empty())
+        {
+            h = free_lists[index].back();
+            free_lists[index].pop_back();
+            counters.cached_bytes -= class_bytes(index);
+            counters.hits++;
+        }
+        else
+        {
+            counters.misses++;
+        }
+    }
+
+    if (!h)
+    {
+        HugePages backing = huge_pages();
+        if (backing != HugePages::Off && class_bytes(index) >= kHugePageBytes)
+            h = map_block(index, backing);
+    }
+
+    if (!h)
+    {
+        void *raw = std::aligned_alloc(kAlignment, sizeof(Header) + class_bytes(index));
+        if (!raw)
+            throw std::bad_alloc();
+        h = static_cast<Header *>(raw);
+        h->magic = kMagic;
+        h->size_class = uint32_t(index);
+        h->mapped_bytes = 0;
+        h->owner = this;
+        if (numa_node >= 0)
+            NumaTopology::bind_memory(h, sizeof(Header) + class_bytes(index), numa_node);
+    }
+    return h + 1;
+}
+
+BufferPool::Header *BufferPool::map_block(size_t index, HugePages backing)
+{
+    const size_t length = (sizeof(Header) + class_bytes(index) + kHugePageBytes - 1) /
+                          kHugePageBytes * kHugePageBytes;
+    void *p = MAP_FAILED;
+
+    if (backing == HugePages::Explicit)
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (p == MAP_FAILED)
+    {
+        // Over‑map by one huge page and trim so the region is 2 MiB aligned;
+        // otherwise THP can only back the aligned middle of the block.
+        void *raw = mmap(nullptr, length + kHugePageBytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            return nullptr;
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + kHugePageBytes - 1) & ~(kHugePageBytes - 1);
+        if (aligned > start)
+            munmap(raw, aligned - start);
+        if (size_t tail = start + kHugePageBytes - aligned)
+            munmap(reinterpret_cast<void *>(aligned + length), tail);
+
+        p = reinterpret_cast<void *>(aligned);
+        madvise(p, length, MADV_HUGEPAGE);
+    }
+
+    if (numa_node >= 0)
+        NumaTopology::bind_memory(p, length, numa_node);
+
+    Header *h = static_cast<Header *>(p);
+    h->magic = kMagic;
+    h->size_class = uint32_t(index);
+    h->mapped_bytes = length;
+    h->owner = this;
+    return h;
+}
+
+void BufferPool::free_block(Header *h)
+{
+    if (h->mapped_bytes)
+        munmap(h, h->mapped_bytes);
+    else
+        std::free(h);
+}
+
+void BufferPool::release(void *p)
+{
+    if (!p)
+        return;
+
+    Header *h = static_cast<Header *>(p) - 1;
+    if (h->magic != kMagic)
+        std::abort(); // not ours: freeing it would corrupt the heap
+    if (h->owner != this)
+        return h->owner->release(p);
+
+    const size_t index = h->size_class;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (counters.cached_bytes + class_bytes(index) <= max_cached_bytes)
+        {
+            if (free_lists.size() <= index)
+                free_lists.resize(index + 1);
+            free_lists[index].push_back(h);
+            counters.cached_bytes += class_bytes(index);
+            return;
+        }
+    }
+    free_block(h);
+}
+
+void *BufferPool::reallocate(void *p, size_t bytes)
+{
+    if (!p)
+        return allocate(bytes);
+
+    Header *h = static_cast<Header *>(p) - 1;
+    const size_t capacity = class_bytes(h->size_class);
+    if (bytes <= capacity)
+        return p;
+
+    void *q = allocate(bytes);
+    std::memcpy(q, p, capacity);
+    release(p);
+    return q;
+}
+
+void BufferPool::trim()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &list : free_lists)
+    {
+        for (Header *h : list)
+            free_block(h);
+        list.clear();
+    }
+    counters.cached_bytes = 0;
+}
+
+BufferPool::Stats BufferPool::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void BufferPool::set_huge_pages(HugePages backing)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    policy = backing;
+}
+
+BufferPool::HugePages BufferPool::huge_pages() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return policy;
+}
+
+BufferPool::HugePages BufferPool::parse_huge_pages(const std::string &name)
+{
+    if (name == "off")
+        return HugePages::Off;
+    if (name == "thp")
+        return HugePages::Transparent;
+    if (name == "explicit")
+        return HugePages::Explicit;
+    throw std::runtime_error("Unknown huge page mode: " + name);
+}
@@ -1,7 +1,16 @@
 #include <CAR-practica2/convolution.hpp>
+#include <CAR-practica2/jit.hpp>
+#include <CAR-practica2/static_kernel.hpp>
 #include <immintrin.h>
 #include <iostream>
 #include <chrono>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <CAR-practica2/trace.hpp>
+
+// Rows per "convolve_band" trace event.
+constexpr int kTraceBandRows = 64;
 
 ConvolutionKernel::ConvolutionKernel(
     std::initializer_list<std::initializer_list<float>> init)
@@ -18,7 +27,32 @@ ConvolutionKernel::ConvolutionKernel(
     }
 }
 
-void do_scalar_pixel(int x, int y, const Image &img, Image &out, const ConvolutionKernel &kernel)
+/**
+ * Output images are not zero‑initialized, so backends clear the one‑pixel
+ * border they do not compute (the reference behaviour of apply_linear).
+ */
+void clear_border(Image &out)
+{
+    const size_t row_bytes = size_t(out.width) * out.nChannels;
+
+    if (out.height <= 2 || out.width <= 2)
+    {
+        for (int y = 0; y < out.height; y++)
+            std::memset(out.row(y), 0, row_bytes);
+        return;
+    }
+
+    std::memset(out.row(0), 0, row_bytes);
+    std::memset(out.row(out.height - 1), 0, row_bytes);
+    for (int y = 1; y < out.height - 1; y++)
+    {
+        std::memset(out.row(y), 0, out.nChannels);
+        std::memset(out.row(y) + row_bytes - out.nChannels, 0, out.nChannels);
+    }
+}
+
+void do_scalar_pixel(int x, const unsigned char *const rows[3], unsigned char *out,
+                     int nChannels, const ConvolutionKernel &kernel)
 {
     float acc[4] = {0, 0, 0, 0};
 
@@ -27,55 +61,414 @@ void do_scalar_pixel(int x, int y, const Image &img, Image &out, const Convoluti
         for (int kx = -1; kx <= 1; kx++)
         {
             int px = x + kx;
-            int py = y + ky;
             float weight = kernel.data[ky + 1][kx + 1];
+            const unsigned char *p = rows[ky + 1] + px * nChannels;
 
-            for (int c = 0; c < img.nChannels; c++)
+            for (int c = 0; c < nChannels; c++)
             {
-                acc[c] += img.get(px, py, c) * weight;
+                acc[c] += p[c] * weight;
             }
         }
     }
 
-    for (int c = 0; c < img.nChannels; c++)
+    unsigned char *o = out + x * nChannels;
+    for (int c = 0; c < nChannels; c++)
+    {
+        o[c] = std::clamp(acc[c], 0.0f, 255.0f);
+    }
+}
+
+/**
+ * A row kernel computes the interior pixels (1 ≤ x < width − 1) of one output
+ * row from the three input rows around it: rows[0] = y − 1, rows[1] = y,
+ * rows[2] = y + 1. Backends are written as row kernels so the same code serves
+ * whole images, views and the in‑place line buffer.
+ */
+using RowKernel = void (*)(const unsigned char *const rows[3], unsigned char *out,
+                           int width, int nChannels, const ConvolutionKernel &kernel);
+
+void linear_row(const unsigned char *const rows[3], unsigned char *out,
+                int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    for (int x = 1; x < width - 1; x++)
+    {
+
+        do_scalar_pixel(x, rows, out, nChannels, kernel);
+    }
+}
+
+void Convolver::check_views(ConstImageView img, ImageView out)
+{
+    if (img.width != out.width || img.height != out.height || img.nChannels != out.nChannels)
+        throw std::runtime_error("Convolution source and destination views differ in size");
+    if (img.nChannels < 1 || img.nChannels > 4)
+        throw std::runtime_error("Unsupported channel count for convolution");
+}
+
+void convolve_rows(ConstImageView img, ImageView out, const ConvolutionKernel &kernel,
+                   RowKernel row_kernel)
+{
+    Convolver::check_views(img, out);
+
+    for (int band = 1; band < img.height - 1; band += kTraceBandRows)
+    {
+        CAR_TRACE_SCOPE("convolve_band", band);
+        const int band_end = std::min(band + kTraceBandRows, img.height - 1);
+
+        for (int y = band; y < band_end; y++)
+        {
+            const unsigned char *rows[3] = {img.row(y - 1), img.row(y), img.row(y + 1)};
+            row_kernel(rows, out.row(y), img.width, img.nChannels, kernel);
+        }
+    }
+}
+
+/**
+ * A block kernel computes nRows (1 … its block factor) consecutive output
+ * rows in one pass: rows[0 … nRows + 1] are the input rows from y − 1 to
+ * y + nRows, out[0 … nRows − 1] the output rows from y. Every input row is
+ * loaded once per horizontal tap and used for all (up to three) output rows
+ * that need it, instead of once per output row.
+ *
+ * Each output still accumulates its taps in the reference order (ky, then
+ * kx): input row j contributes to output r with ky = j − r, and j ascends.
+ */
+using BlockKernel = void (*)(const unsigned char *const *rows, unsigned char *const *out, int nRows,
+                             int width, int nChannels, const ConvolutionKernel &kernel);
+
+void convolve_blocks(ConstImageView img, ImageView out, const ConvolutionKernel &kernel,
+                     BlockKernel block_kernel, int block_rows)
+{
+    Convolver::check_views(img, out);
+
+    for (int band = 1; band < img.height - 1; band += kTraceBandRows)
+    {
+        CAR_TRACE_SCOPE("convolve_band", band);
+        const int band_end = std::min(band + kTraceBandRows, img.height - 1);
+
+        for (int y = band; y < band_end; y += block_rows)
+        {
+            const int n = std::min(block_rows, band_end - y);
+            const unsigned char *rows[6];
+            unsigned char *outs[4];
+            for (int j = 0; j < n + 2; j++)
+                rows[j] = img.row(y - 1 + j);
+            for (int r = 0; r < n; r++)
+                outs[r] = out.row(y + r);
+            block_kernel(rows, outs, n, img.width, img.nChannels, kernel);
+        }
+    }
+}
+
+/**
+ * Scalar block kernel behind apply_linear(). The row is a flat byte stream
+ * (neighbours at ±nChannels), and each loaded byte feeds R accumulators.
+ */
+template <int R>
+void linear_rows(const unsigned char *const *rows, unsigned char *const *out,
+                 int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    const int end = (width - 1) * nChannels;
+    for (int i = nChannels; i < end; i++)
+    {
+        float acc[R] = {};
+        for (int j = 0; j < R + 2; j++)
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const float v = rows[j][i + (kx - 1) * nChannels];
+                for (int r = 0; r < R; r++)
+                    if (j - r >= 0 && j - r <= 2)
+                        acc[r] += v * kernel.data[j - r][kx];
+            }
+        for (int r = 0; r < R; r++)
+            out[r][i] = std::clamp(acc[r], 0.0f, 255.0f);
+    }
+}
+
+/// Output rows per pass of the scalar block kernel (4 spills registers).
+constexpr int kLinearBlockRows = 3;
+
+void linear_block(const unsigned char *const *rows, unsigned char *const *out, int nRows,
+                  int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    switch (nRows)
+    {
+    case 3:
+        return linear_rows<3>(rows, out, width, nChannels, kernel);
+    case 2:
+        return linear_rows<2>(rows, out, width, nChannels, kernel);
+    default:
+        return linear_rows<1>(rows, out, width, nChannels, kernel);
+    }
+}
+
+/**
+ * Streaming variant of convolve_rows(): each output row is computed into a
+ * line buffer that stays in L1 and then written with non‑temporal stores, so
+ * the output bypasses the caches instead of evicting the input. Whole vectors
+ * are stored, covering the zero border pixels and up to 15 bytes of padding.
+ */
+void convolve_rows_streaming(ConstImageView img, ImageView out, const ConvolutionKernel &kernel,
+                             RowKernel row_kernel)
+{
+    Convolver::check_views(img, out);
+
+    const size_t row_bytes = size_t(img.width) * img.nChannels;
+    const size_t vectors = (row_bytes + 15) / 16;
+    PixelBuffer line(vectors * 16);
+    std::memset(line.data(), 0, line.size()); // row kernels never write the border
+
+    for (int band = 1; band < img.height - 1; band += kTraceBandRows)
     {
-        out.set(x, y, c, acc[c]);
+        CAR_TRACE_SCOPE("convolve_band", band);
+        const int band_end = std::min(band + kTraceBandRows, img.height - 1);
+
+        for (int y = band; y < band_end; y++)
+        {
+            // Row y + 2 is the new input row of the next iteration.
+            if (y + 2 < img.height)
+            {
+                const unsigned char *ahead = img.row(y + 2);
+                for (size_t offset = 0; offset < row_bytes; offset += 64)
+                    _mm_prefetch(reinterpret_cast<const char *>(ahead + offset), _MM_HINT_T0);
+            }
+
+            const unsigned char *rows[3] = {img.row(y - 1), img.row(y), img.row(y + 1)};
+            row_kernel(rows, line.data(), img.width, img.nChannels, kernel);
+
+            const __m128i *src = reinterpret_cast<const __m128i *>(line.data());
+            __m128i *dst = reinterpret_cast<__m128i *>(out.row(y));
+            for (size_t i = 0; i < vectors; i++)
+                _mm_stream_si128(dst + i, _mm_load_si128(src + i));
+        }
     }
+    // Non‑temporal stores are weakly ordered; publish them before returning.
+    _mm_sfence();
+}
+
+/**
+ * Whether a whole‑row destination should be written with streaming stores:
+ * rows must be 16‑byte aligned with room for the last partial vector.
+ */
+bool use_streaming(ConstImageView img, ImageView out, StoreMode mode)
+{
+    if (mode == StoreMode::Cached || img.height < 3)
+        return false;
+
+    const size_t row_bytes = size_t(out.width) * out.nChannels;
+    const bool aligned = reinterpret_cast<uintptr_t>(out.data) % 16 == 0 &&
+                         out.stride % 16 == 0 &&
+                         size_t(out.stride) >= (row_bytes + 15) / 16 * 16;
+    if (!aligned)
+        return false;
+    if (mode == StoreMode::Streaming)
+        return true;
+
+    const size_t frame_bytes = size_t(img.stride) * img.height + size_t(out.stride) * out.height;
+    return frame_bytes > Convolver::last_level_cache_bytes();
+}
+
+size_t Convolver::last_level_cache_bytes()
+{
+    static const size_t bytes = []() -> size_t
+    {
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        for (int name : {_SC_LEVEL4_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE})
+        {
+            long size = sysconf(name);
+            if (size > 0)
+                return size_t(size);
+        }
+#endif
+        // Highest cache index listed in sysfs, e.g. "32768K".
+        for (int index = 4; index >= 0; index--)
+        {
+            std::ifstream in("/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/size");
+            size_t size = 0;
+            char unit = 0;
+            if (in >> size)
+            {
+                in >> unit;
+                return unit == 'M' ? size << 20 : unit == 'K' ? size << 10 : size;
+            }
+        }
+        return size_t(8) << 20;
+    }();
+    return bytes;
+}
+
+StoreMode Convolver::parse_store_mode(const std::string &name)
+{
+    if (name == "auto")
+        return StoreMode::Auto;
+    if (name == "cached")
+        return StoreMode::Cached;
+    if (name == "streaming")
+        return StoreMode::Streaming;
+    throw std::runtime_error("Unknown store mode: " + name);
 }
 
 ConvolutionResult Convolver::do_convolve(const Image &img,
                                          const ConvolutionKernel &kernel,
                                          bool use_simd)
+{
+    return do_convolve(img, kernel, use_simd ? Backend::Simd : Backend::Linear);
+}
+
+ConvolutionResult Convolver::do_convolve(const Image &img,
+                                         const ConvolutionKernel &kernel,
+                                         Backend backend)
+{
+    Image result;
+    double seconds = do_convolve(img, result, kernel, backend);
+    return ConvolutionResult{std::move(result), seconds};
+}
+
+double Convolver::do_convolve(const Image &img, Image &out,
+                              const ConvolutionKernel &kernel, Backend backend)
 {
     using clock = std::chrono::high_resolution_clock;
     auto start = clock::now();
 
-    Image result = use_simd
-                       ? apply_simd(img, kernel)
-                       : apply_linear(img, kernel);
+    out.reshape(img.width, img.height, img.nChannels);
+    clear_border(out);
+    run_backend(img.view(), out.view(), kernel, backend, true);
+
+    std::chrono::duration<double> elapsed = clock::now() - start;
+    return elapsed.count();
+}
+
+double Convolver::do_convolve(ConstImageView img, ImageView out,
+                              const ConvolutionKernel &kernel, Backend backend)
+{
+    using clock = std::chrono::high_resolution_clock;
+    auto start = clock::now();
 
-    auto end = clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    run_backend(img, out, kernel, backend);
 
-    return ConvolutionResult{std::move(result), elapsed.count()};
+    std::chrono::duration<double> elapsed = clock::now() - start;
+    return elapsed.count();
 }
 
-Image Convolver::apply_linear(const Image &img, const ConvolutionKernel &kernel)
+double Convolver::iterate(DoubleBuffer &buffers, const ConvolutionKernel &kernel,
+                          int passes, Backend backend)
 {
-    Image out(img.width, img.height, img.nChannels);
+    double seconds = 0;
+    for (int i = 0; i < passes; i++)
+    {
+        seconds += do_convolve(buffers.front(), buffers.back(), kernel, backend);
+        buffers.swap();
+    }
+    return seconds;
+}
 
-    for (int y = 1; y < img.height - 1; y++)
+RowKernel row_kernel_for(Backend backend);
+
+void Convolver::run_backend(ConstImageView img, ImageView out,
+                            const ConvolutionKernel &kernel, Backend backend,
+                            bool whole_rows)
+{
+    CAR_TRACE_SCOPE("convolve");
+    if (whole_rows && use_streaming(img, out, stores))
     {
-        for (int x = 1; x < img.width - 1; x++)
-        {
+        convolve_rows_streaming(img, out, kernel, row_kernel_for(backend));
+        return;
+    }
 
-            do_scalar_pixel(x, y, img, out, kernel);
-        }
+    switch (backend)
+    {
+    case Backend::Simd:
+        apply_simd(img, out, kernel);
+        break;
+    case Backend::SimdGather:
+        convolve_rows(img, out, kernel, row_kernel_for(backend));
+        break;
+    case Backend::ByteStream:
+        apply_byte_stream(img, out, kernel);
+        break;
+    case Backend::Blocked:
+        apply_blocked(img, out, kernel);
+        break;
+    case Backend::Fma:
+        apply_fma(img, out, kernel);
+        break;
+    case Backend::Algebraic:
+        apply_algebraic(img, out, kernel);
+        break;
+    case Backend::Static:
+        apply_static(img, out, kernel);
+        break;
+    case Backend::Jit:
+        apply_jit(img, out, kernel);
+        break;
+    case Backend::Winograd:
+        apply_winograd(img, out, kernel);
+        break;
+    default:
+        apply_linear(img, out, kernel);
+        break;
+    }
+}
+
+const char *Convolver::backend_name(Backend backend)
+{
+    switch (backend)
+    {
+    case Backend::Simd:
+        return "simd";
+    case Backend::SimdGather:
+        return "simd-gather";
+    case Backend::ByteStream:
+        return "bytestream";
+    case Backend::Blocked:
+        return "blocked";
+    case Backend::Fma:
+        return "fma";
+    case Backend::Algebraic:
+        return "algebraic";
+    case Backend::Static:
+        return "static";
+    case Backend::Jit:
+        return "jit";
+    case Backend::Winograd:
+        return "winograd";
+    default:
+        return "linear";
     }
+}
+
+Backend Convolver::parse_backend(const std::string &name)
+{
+    for (Backend backend : backends())
+        if (name == backend_name(backend))
+            return backend;
+    throw std::runtime_error("Unknown backend: " + name);
+}
+
+std::vector<Backend> Convolver::backends()
+{
+    return {Backend::Linear, Backend::Simd, Backend::SimdGather, Backend::ByteStream, Backend::Blocked, Backend::Fma,
+            Backend::Algebraic, Backend::Static, Backend::Jit, Backend::Winograd};
+}
+
+bool Convolver::bit_exact(Backend backend)
+{
+    return backend != Backend::Fma && backend != Backend::Winograd;
+}
 
+Image Convolver::apply_linear(const Image &img, const ConvolutionKernel &kernel)
+{
+    Image out(img.width, img.height, img.nChannels);
+    clear_border(out);
+    apply_linear(img.view(), out.view(), kernel);
     return out;
 }
 
+void Convolver::apply_linear(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    convolve_blocks(img, out, kernel, linear_block, kLinearBlockRows);
+}
+
 /**
  * apply_simd(img, kernel)
  *
@@ -105,85 +498,1563 @@ Image Convolver::apply_linear(const Image &img, const ConvolutionKernel &kernel)
  */
 Image Convolver::apply_simd(const Image &img, const ConvolutionKernel &kernel)
 {
-    const int nChannels = img.nChannels;
-    /*
-    Stride is simply the number of bytes you must skip to move from the start of one
-    image row to the start of the next. It’s used so the code can correctly jump through
-    the 1‑D memory buffer as if it were a 2‑D image.
-    */
-    const int stride = img.width * nChannels;
-    Image out = Image(img.width, img.height, nChannels);
+    Image out = Image(img.width, img.height, img.nChannels);
+    clear_border(out);
+    apply_simd(img.view(), out.view(), kernel);
+    return out;
+}
 
-    // ITERATE OVER IMAGE'S PIXELS
-    for (int imageY = 1; imageY < img.height - 1; imageY++)
+/**
+ * Byte‑stream row kernels. An interleaved row is a flat stream of bytes in
+ * which the horizontal neighbours of a byte sit nChannels bytes to either
+ * side, so one kernel serves gray, RGB and RGBA alike. The interior bytes
+ * [nChannels, (width − 1) × nChannels) are processed 16, 32 or 64 at a time;
+ * as in simd_row the last block is shifted back instead of a scalar tail, and
+ * all loads and stores stay inside the row. Every byte is accumulated in the
+ * reference tap order, so the result is identical to apply_linear().
+ */
+void bytestream_row_16(const unsigned char *const rows[3], unsigned char *out,
+                       int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    if (end - begin < 16)
     {
-        int imageX = 1;
-        for (; imageX < img.width - 1 - 3; imageX += 4)
-        {
-            __m128 sumR = _mm_setzero_ps();
-            __m128 sumG = _mm_setzero_ps();
-            __m128 sumB = _mm_setzero_ps();
+        linear_row(rows, out, width, nChannels, kernel);
+        return;
+    }
+
+    for (int block = begin; block < end; block += 16)
+    {
+        const int i = std::min(block, end - 16);
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+        __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+
+        for (int ky = 0; ky < 3; ky++)
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const __m128 w = _mm_set1_ps(kernel.data[ky][kx]);
+                const __m128i v = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(rows[ky] + i + (kx - 1) * nChannels));
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(v)), w));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4))), w));
+                acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8))), w));
+                acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12))), w));
+            }
+
+        __m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(acc0), _mm_cvttps_epi32(acc1));
+        __m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(acc2), _mm_cvttps_epi32(acc3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(lo, hi));
+    }
+}
+
+__attribute__((target("avx2"))) void bytestream_row_32(const unsigned char *const rows[3], unsigned char *out,
+                                                       int width, int nChannels,
+                                                       const ConvolutionKernel &kernel)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    if (end - begin < 32)
+    {
+        bytestream_row_16(rows, out, width, nChannels, kernel);
+        return;
+    }
+
+    // packs/packus work per 128‑bit lane; this restores the byte order.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (int block = begin; block < end; block += 32)
+    {
+        const int i = std::min(block, end - 32);
+        __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+
+        for (int ky = 0; ky < 3; ky++)
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const __m256 w = _mm256_set1_ps(kernel.data[ky][kx]);
+                const unsigned char *p = rows[ky] + i + (kx - 1) * nChannels;
+                for (int q = 0; q < 4; q++)
+                {
+                    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 8 * q));
+                    __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+                    acc[q] = _mm256_add_ps(acc[q], _mm256_mul_ps(v, w));
+                }
+            }
+
+        __m256i lo = _mm256_packs_epi32(_mm256_cvttps_epi32(acc[0]), _mm256_cvttps_epi32(acc[1]));
+        __m256i hi = _mm256_packs_epi32(_mm256_cvttps_epi32(acc[2]), _mm256_cvttps_epi32(acc[3]));
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), bytes);
+    }
+}
+
+// GCC 12's avx512fintrin.h conversions start from _mm512_undefined_*, which
+// -Wmaybe-uninitialized flags once inlined; the values are fully overwritten.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f"))) void bytestream_row_64(const unsigned char *const rows[3], unsigned char *out,
+                                                           int width, int nChannels,
+                                                           const ConvolutionKernel &kernel)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    if (end - begin < 64)
+    {
+        bytestream_row_32(rows, out, width, nChannels, kernel);
+        return;
+    }
+
+    const __m512i zero = _mm512_setzero_si512();
+
+    for (int block = begin; block < end; block += 64)
+    {
+        const int i = std::min(block, end - 64);
+        __m512 acc[4] = {_mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps()};
 
-            // ITERATE OVER KERNEL
-            for (int kernelY = -1; kernelY <= 1; kernelY++)
+        for (int ky = 0; ky < 3; ky++)
+            for (int kx = 0; kx < 3; kx++)
             {
-                for (int kernelX = -1; kernelX <= 1; kernelX++)
+                const __m512 w = _mm512_set1_ps(kernel.data[ky][kx]);
+                const unsigned char *p = rows[ky] + i + (kx - 1) * nChannels;
+                for (int q = 0; q < 4; q++)
                 {
-                    float currentKernelWeight = kernel.data[kernelY + 1][kernelX + 1];
-                    __m128 vectorizedWeight = _mm_set1_ps(currentKernelWeight);
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * q));
+                    __m512 v = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes));
+                    acc[q] = _mm512_add_ps(acc[q], _mm512_mul_ps(v, w));
+                }
+            }
+
+        // max(·, 0) then unsigned saturating narrow = clamp to [0, 255].
+        for (int q = 0; q < 4; q++)
+        {
+            __m512i ints = _mm512_max_epi32(_mm512_cvttps_epi32(acc[q]), zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 16 * q), _mm512_cvtusepi32_epi8(ints));
+        }
+    }
+}
+#pragma GCC diagnostic pop
+
+/// Widest byte‑stream kernel the CPU supports, or the one forced by set_byte_stream_bytes().
+RowKernel bytestream_kernel = nullptr;
+
+RowKernel bytestream_kernel_for(int bytes)
+{
+    switch (bytes)
+    {
+    case 64:
+        return bytestream_row_64;
+    case 32:
+        return bytestream_row_32;
+    default:
+        return bytestream_row_16;
+    }
+}
 
-                    const unsigned char *ptr =
-                        img.data.data() + ((imageY + kernelY) * stride + (imageX + kernelX) * nChannels);
+void bytestream_row(const unsigned char *const rows[3], unsigned char *out,
+                    int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    static const RowKernel widest = bytestream_kernel_for(Convolver::byte_stream_bytes_supported().back());
+    (bytestream_kernel ? bytestream_kernel : widest)(rows, out, width, nChannels, kernel);
+}
 
-                    float r0 = ptr[0];
-                    float g0 = ptr[1];
-                    float b0 = ptr[2];
+std::vector<int> Convolver::byte_stream_bytes_supported()
+{
+    std::vector<int> widths = {16};
+    if (__builtin_cpu_supports("avx2"))
+        widths.push_back(32);
+    if (__builtin_cpu_supports("avx512f"))
+        widths.push_back(64);
+    return widths;
+}
 
-                    float r1 = ptr[3];
-                    float g1 = ptr[4];
-                    float b1 = ptr[5];
+bool Convolver::set_byte_stream_bytes(int bytes)
+{
+    if (bytes == 0)
+    {
+        bytestream_kernel = nullptr;
+        return true;
+    }
+    for (int supported : byte_stream_bytes_supported())
+        if (supported == bytes)
+        {
+            bytestream_kernel = bytestream_kernel_for(bytes);
+            return true;
+        }
+    return false;
+}
 
-                    float r2 = ptr[6];
-                    float g2 = ptr[7];
-                    float b2 = ptr[8];
+void Convolver::apply_byte_stream(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    convolve_rows(img, out, kernel, bytestream_row);
+}
 
-                    float r3 = ptr[9];
-                    float g3 = ptr[10];
-                    float b3 = ptr[11];
+/**
+ * Register‑blocked byte‑stream kernels (see BlockKernel). The block factor
+ * and the bytes per step are chosen per ISA so the accumulators stay in
+ * registers: SSE4.1 computes 2 rows × 16 bytes (8 of 16 xmm), AVX2 4 rows ×
+ * 16 bytes (8 of 16 ymm), AVX‑512 4 rows × 64 bytes (16 of 32 zmm). Bytes
+ * are processed exactly as in the byte‑stream kernels, so results match
+ * apply_linear().
+ */
+template <int R>
+void blocked_rows_sse(const unsigned char *const *rows, unsigned char *const *out,
+                      int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    if (end - begin < 16)
+    {
+        linear_rows<R>(rows, out, width, nChannels, kernel);
+        return;
+    }
 
-                    __m128 R = _mm_set_ps(r3, r2, r1, r0);
-                    __m128 G = _mm_set_ps(g3, g2, g1, g0);
-                    __m128 B = _mm_set_ps(b3, b2, b1, b0);
+    for (int block = begin; block < end; block += 16)
+    {
+        const int i = std::min(block, end - 16);
+        __m128 acc[R][4];
+        for (int r = 0; r < R; r++)
+            for (int q = 0; q < 4; q++)
+                acc[r][q] = _mm_setzero_ps();
 
-                    sumR = _mm_add_ps(sumR, _mm_mul_ps(R, vectorizedWeight));
-                    sumG = _mm_add_ps(sumG, _mm_mul_ps(G, vectorizedWeight));
-                    sumB = _mm_add_ps(sumB, _mm_mul_ps(B, vectorizedWeight));
+        for (int j = 0; j < R + 2; j++)
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const __m128i b = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(rows[j] + i + (kx - 1) * nChannels));
+                const __m128 v[4] = {_mm_cvtepi32_ps(_mm_cvtepu8_epi32(b)),
+                                     _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(b, 4))),
+                                     _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(b, 8))),
+                                     _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(b, 12)))};
+                for (int r = 0; r < R; r++)
+                {
+                    if (j - r < 0 || j - r > 2)
+                        continue;
+                    const __m128 w = _mm_set1_ps(kernel.data[j - r][kx]);
+                    for (int q = 0; q < 4; q++)
+                        acc[r][q] = _mm_add_ps(acc[r][q], _mm_mul_ps(v[q], w));
                 }
             }
 
-            __m128i r32 = _mm_cvttps_epi32(sumR);
-            __m128i g32 = _mm_cvttps_epi32(sumG);
-            __m128i b32 = _mm_cvttps_epi32(sumB);
+        for (int r = 0; r < R; r++)
+        {
+            __m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(acc[r][0]), _mm_cvttps_epi32(acc[r][1]));
+            __m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(acc[r][2]), _mm_cvttps_epi32(acc[r][3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out[r] + i), _mm_packus_epi16(lo, hi));
+        }
+    }
+}
+
+template <int R>
+__attribute__((target("avx2"))) void blocked_rows_avx2(const unsigned char *const *rows, unsigned char *const *out,
+                                                       int width, int nChannels,
+                                                       const ConvolutionKernel &kernel)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    if (end - begin < 16)
+    {
+        linear_rows<R>(rows, out, width, nChannels, kernel);
+        return;
+    }
 
-            alignas(16) int r[4], g[4], b[4];
-            _mm_store_si128((__m128i *)r, r32);
-            _mm_store_si128((__m128i *)g, g32);
-            _mm_store_si128((__m128i *)b, b32);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
 
-            uint8_t *outputPtr = out.data.data() + (imageY * stride + imageX * nChannels);
+    for (int block = begin; block < end; block += 16)
+    {
+        const int i = std::min(block, end - 16);
+        __m256 acc[R][2];
+        for (int r = 0; r < R; r++)
+            acc[r][0] = acc[r][1] = _mm256_setzero_ps();
 
-            for (int i = 0; i < 4; i++)
+        for (int j = 0; j < R + 2; j++)
+            for (int kx = 0; kx < 3; kx++)
             {
-                outputPtr[i * 3 + 0] = std::clamp(r[i], 0, 255);
-                outputPtr[i * 3 + 1] = std::clamp(g[i], 0, 255);
-                outputPtr[i * 3 + 2] = std::clamp(b[i], 0, 255);
+                const unsigned char *p = rows[j] + i + (kx - 1) * nChannels;
+                const __m256 v0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p))));
+                const __m256 v1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 8))));
+                for (int r = 0; r < R; r++)
+                {
+                    if (j - r < 0 || j - r > 2)
+                        continue;
+                    const __m256 w = _mm256_set1_ps(kernel.data[j - r][kx]);
+                    acc[r][0] = _mm256_add_ps(acc[r][0], _mm256_mul_ps(v0, w));
+                    acc[r][1] = _mm256_add_ps(acc[r][1], _mm256_mul_ps(v1, w));
+                }
             }
+
+        for (int r = 0; r < R; r++)
+        {
+            __m256i words = _mm256_packs_epi32(_mm256_cvttps_epi32(acc[r][0]), _mm256_cvttps_epi32(acc[r][1]));
+            __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words, words), order);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out[r] + i), _mm256_castsi256_si128(bytes));
         }
+    }
+}
 
-        // TAIL LOOP
-        for (; imageX < img.width - 1; imageX++)
-            do_scalar_pixel(imageX, imageY, img, out, kernel);
+// Same GCC 12 avx512fintrin.h -Wmaybe-uninitialized false positive as bytestream_row_64.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+template <int R>
+__attribute__((target("avx512f"))) void blocked_rows_avx512(const unsigned char *const *rows, unsigned char *const *out,
+                                                            int width, int nChannels,
+                                                            const ConvolutionKernel &kernel)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    if (end - begin < 64)
+    {
+        blocked_rows_avx2<R>(rows, out, width, nChannels, kernel);
+        return;
     }
 
-    return out;
+    const __m512i zero = _mm512_setzero_si512();
+
+    for (int block = begin; block < end; block += 64)
+    {
+        const int i = std::min(block, end - 64);
+        __m512 acc[R][4];
+        for (int r = 0; r < R; r++)
+            for (int q = 0; q < 4; q++)
+                acc[r][q] = _mm512_setzero_ps();
+
+        for (int j = 0; j < R + 2; j++)
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const unsigned char *p = rows[j] + i + (kx - 1) * nChannels;
+                __m512 v[4];
+                for (int q = 0; q < 4; q++)
+                    v[q] = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * q))));
+                for (int r = 0; r < R; r++)
+                {
+                    if (j - r < 0 || j - r > 2)
+                        continue;
+                    const __m512 w = _mm512_set1_ps(kernel.data[j - r][kx]);
+                    for (int q = 0; q < 4; q++)
+                        acc[r][q] = _mm512_add_ps(acc[r][q], _mm512_mul_ps(v[q], w));
+                }
+            }
+
+        for (int r = 0; r < R; r++)
+            for (int q = 0; q < 4; q++)
+            {
+                __m512i ints = _mm512_max_epi32(_mm512_cvttps_epi32(acc[r][q]), zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out[r] + i + 16 * q), _mm512_cvtusepi32_epi8(ints));
+            }
+    }
+}
+#pragma GCC diagnostic pop
+
+/**
+ * Instantiates a blocked kernel template for every row count up to its
+ * block factor, so partial blocks at band ends use the same code.
+ */
+template <void (*F1)(const unsigned char *const *, unsigned char *const *, int, int, const ConvolutionKernel &),
+          void (*F2)(const unsigned char *const *, unsigned char *const *, int, int, const ConvolutionKernel &),
+          void (*F3)(const unsigned char *const *, unsigned char *const *, int, int, const ConvolutionKernel &),
+          void (*F4)(const unsigned char *const *, unsigned char *const *, int, int, const ConvolutionKernel &)>
+void blocked_dispatch(const unsigned char *const *rows, unsigned char *const *out, int nRows,
+                      int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    switch (nRows)
+    {
+    case 4:
+        return F4(rows, out, width, nChannels, kernel);
+    case 3:
+        return F3(rows, out, width, nChannels, kernel);
+    case 2:
+        return F2(rows, out, width, nChannels, kernel);
+    default:
+        return F1(rows, out, width, nChannels, kernel);
+    }
+}
+
+struct BlockedKernel
+{
+    BlockKernel kernel;
+    int rows; ///< Block factor.
+};
+
+BlockedKernel blocked_kernel_for(int bytes)
+{
+    switch (bytes)
+    {
+    case 64:
+        return {blocked_dispatch<blocked_rows_avx512<1>, blocked_rows_avx512<2>,
+                                 blocked_rows_avx512<3>, blocked_rows_avx512<4>>,
+                4};
+    case 32:
+        return {blocked_dispatch<blocked_rows_avx2<1>, blocked_rows_avx2<2>,
+                                 blocked_rows_avx2<3>, blocked_rows_avx2<4>>,
+                4};
+    default:
+        return {blocked_dispatch<blocked_rows_sse<1>, blocked_rows_sse<2>,
+                                 blocked_rows_sse<2>, blocked_rows_sse<2>>,
+                2};
+    }
+}
+
+/// Blocked kernel forced by set_blocked_vector_bytes(); null kernel for the widest.
+BlockedKernel forced_blocked_kernel = {nullptr, 0};
+
+BlockedKernel blocked_kernel()
+{
+    static const BlockedKernel widest = blocked_kernel_for(Convolver::byte_stream_bytes_supported().back());
+    return forced_blocked_kernel.kernel ? forced_blocked_kernel : widest;
+}
+
+bool Convolver::set_blocked_vector_bytes(int bytes)
+{
+    if (bytes == 0)
+    {
+        forced_blocked_kernel = {nullptr, 0};
+        return true;
+    }
+    for (int supported : byte_stream_bytes_supported())
+        if (supported == bytes)
+        {
+            forced_blocked_kernel = blocked_kernel_for(bytes);
+            return true;
+        }
+    return false;
+}
+
+/// One‑row form of the blocked kernel, for the streaming and in‑place paths.
+void blocked_row(const unsigned char *const rows[3], unsigned char *out,
+                 int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    blocked_kernel().kernel(rows, &out, 1, width, nChannels, kernel);
+}
+
+void Convolver::apply_blocked(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    const BlockedKernel blocked = blocked_kernel();
+    convolve_blocks(img, out, kernel, blocked.kernel, blocked.rows);
+}
+
+/**
+ * FMA byte‑stream kernel, 32 bytes per step. The nine weights are broadcast
+ * once by the caller and stay in registers (9 of 16 ymm, next to the 4
+ * accumulators); each tap is one _mm256_fmadd_ps. The fused multiply‑add
+ * rounds once instead of twice, so for weights whose products are not exact
+ * in float the result can differ from apply_linear() by one level.
+ */
+__attribute__((target("avx2,fma"))) void fma_row(const unsigned char *const rows[3], unsigned char *out,
+                                                 int width, int nChannels, const __m256 weights[9])
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (int block = begin; block < end; block += 32)
+    {
+        const int i = std::min(block, end - 32);
+        __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+
+        for (int ky = 0; ky < 3; ky++)
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const unsigned char *p = rows[ky] + i + (kx - 1) * nChannels;
+                for (int q = 0; q < 4; q++)
+                {
+                    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 8 * q));
+                    __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+                    acc[q] = _mm256_fmadd_ps(v, weights[ky * 3 + kx], acc[q]);
+                }
+            }
+
+        __m256i lo = _mm256_packs_epi32(_mm256_cvttps_epi32(acc[0]), _mm256_cvttps_epi32(acc[1]));
+        __m256i hi = _mm256_packs_epi32(_mm256_cvttps_epi32(acc[2]), _mm256_cvttps_epi32(acc[3]));
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), bytes);
+    }
+}
+
+__attribute__((target("avx2,fma"))) void fma_rows(ConstImageView img, ImageView out,
+                                                  const ConvolutionKernel &kernel)
+{
+    __m256 weights[9];
+    for (int t = 0; t < 9; t++)
+        weights[t] = _mm256_set1_ps(kernel.data[t / 3][t % 3]);
+
+    for (int band = 1; band < img.height - 1; band += kTraceBandRows)
+    {
+        CAR_TRACE_SCOPE("convolve_band", band);
+        const int band_end = std::min(band + kTraceBandRows, img.height - 1);
+
+        for (int y = band; y < band_end; y++)
+        {
+            const unsigned char *rows[3] = {img.row(y - 1), img.row(y), img.row(y + 1)};
+            if ((img.width - 2) * img.nChannels < 32)
+                linear_row(rows, out.row(y), img.width, img.nChannels, kernel);
+            else
+                fma_row(rows, out.row(y), img.width, img.nChannels, weights);
+        }
+    }
+}
+
+bool fma_supported()
+{
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+
+/// One row with the weights broadcast for it alone.
+__attribute__((target("avx2,fma"))) void fma_row_broadcast(const unsigned char *const rows[3], unsigned char *out,
+                                                           int width, int nChannels,
+                                                           const ConvolutionKernel &kernel)
+{
+    __m256 weights[9];
+    for (int t = 0; t < 9; t++)
+        weights[t] = _mm256_set1_ps(kernel.data[t / 3][t % 3]);
+    fma_row(rows, out, width, nChannels, weights);
+}
+
+/// Row‑kernel form for the streaming and in‑place paths. Not target‑specific,
+/// so no AVX instruction can run before the CPU check, as in apply_fma().
+void fma_row_kernel(const unsigned char *const rows[3], unsigned char *out,
+                    int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    if (!fma_supported())
+        return bytestream_row(rows, out, width, nChannels, kernel);
+    if ((width - 2) * nChannels < 32)
+        return linear_row(rows, out, width, nChannels, kernel);
+    fma_row_broadcast(rows, out, width, nChannels, kernel);
+}
+
+void Convolver::apply_fma(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    if (!fma_supported())
+        return apply_byte_stream(img, out, kernel);
+    check_views(img, out);
+    fma_rows(img, out, kernel);
+}
+
+/**
+ * Algebraic backend (apply_algebraic). The interior of a row is processed in
+ * chunks of kAlgebraicChunk bytes held in small integer arrays; every pass is
+ * one simple loop over a chunk, so skipped taps cost nothing and each loop
+ * vectorizes. Sums are int16_t when the kernel's integers are small enough
+ * (edge, sharpen, blur) and int32_t otherwise. The loops are always_inline
+ * templates, so the AVX2 and AVX‑512BW entry points compile them again for
+ * wider vectors.
+ */
+constexpr int kAlgebraicChunk = 512;
+/// Output rows per strip; with more, the strip's input rows start evicting each other.
+constexpr int kAlgebraicBlockRows = 16;
+
+/// Evaluation plan for the integer strategies of a KernelAnalysis.
+struct AlgebraicPlan
+{
+    KernelStrategy strategy = KernelStrategy::Direct;
+    int shift = 0;
+    bool narrow = false; ///< int16_t sums cannot overflow.
+
+    // Sparse: taps (ky × 3 + kx) grouped by weight; group g is
+    // taps[group_end[g − 1] … group_end[g]) with weight group_weight[g].
+    int groups = 0;
+    int taps[9] = {};
+    int group_end[9] = {};
+    int group_weight[9] = {};
+
+    // Separable and box‑plus‑centre: scale × Σ column[ky] · (row pass of
+    // input row ky) + center × centre pixel.
+    int row[3] = {}, column[3] = {};
+    int scale = 1, center = 0;
+};
+
+AlgebraicPlan algebraic_plan(const KernelAnalysis &analysis)
+{
+    AlgebraicPlan plan;
+    plan.strategy = analysis.strategy;
+    plan.shift = analysis.shift;
+
+    // Bounds every intermediate sum below (largest for the box: 9 |a| + |c − a|).
+    int total = 0, largest = 0;
+    for (int t = 0; t < 9; t++)
+    {
+        total += std::abs(analysis.weights[t / 3][t % 3]);
+        largest = std::max(largest, std::abs(analysis.weights[t / 3][t % 3]));
+    }
+    plan.narrow = 255 * (total + 10 * largest) <= 32767;
+
+    for (int t = 0; t < 9; t++)
+    {
+        const int w = analysis.weights[t / 3][t % 3];
+        if (!w)
+            continue;
+        int g = 0;
+        while (g < plan.groups && plan.group_weight[g] != w)
+            g++;
+        if (g == plan.groups)
+            plan.group_weight[plan.groups++] = w;
+    }
+    int n = 0;
+    for (int g = 0; g < plan.groups; g++)
+    {
+        for (int t = 0; t < 9; t++)
+            if (analysis.weights[t / 3][t % 3] == plan.group_weight[g])
+                plan.taps[n++] = t;
+        plan.group_end[g] = n;
+    }
+
+    if (plan.strategy == KernelStrategy::Separable)
+    {
+        std::copy(analysis.row, analysis.row + 3, plan.row);
+        std::copy(analysis.column, analysis.column + 3, plan.column);
+    }
+    else if (plan.strategy == KernelStrategy::BoxPlusCenter)
+    {
+        std::fill(plan.row, plan.row + 3, 1);
+        std::fill(plan.column, plan.column + 3, 1);
+        plan.scale = analysis.weights[0][0];
+        plan.center = analysis.weights[1][1] - plan.scale;
+    }
+    return plan;
+}
+
+/// acc = w · src (first tap) or acc += w · src; ±1 weights skip the multiply.
+template <typename Sum, typename Src>
+[[gnu::always_inline]] inline void add_tap(Sum *acc, const Src *src, int n, int w, bool first)
+{
+    if (first && w == 1)
+        for (int k = 0; k < n; k++)
+            acc[k] = src[k];
+    else if (first && w == -1)
+        for (int k = 0; k < n; k++)
+            acc[k] = Sum(-src[k]);
+    else if (first)
+        for (int k = 0; k < n; k++)
+            acc[k] = Sum(w * src[k]);
+    else if (w == 1)
+        for (int k = 0; k < n; k++)
+            acc[k] = Sum(acc[k] + src[k]);
+    else if (w == -1)
+        for (int k = 0; k < n; k++)
+            acc[k] = Sum(acc[k] - src[k]);
+    else
+        for (int k = 0; k < n; k++)
+            acc[k] = Sum(acc[k] + w * src[k]);
+}
+
+/// Horizontal pass of one input row over a chunk: h = Σ row[kx] · p(x + kx − 1).
+template <typename Sum>
+[[gnu::always_inline]] inline void algebraic_row_pass(const unsigned char *row, Sum *h, int i, int n,
+                                                      int nChannels, const int weights[3])
+{
+    const unsigned char *p = row + i;
+    const Sum w0 = Sum(weights[0]), w1 = Sum(weights[1]), w2 = Sum(weights[2]);
+    for (int k = 0; k < n; k++)
+        h[k] = Sum(w0 * p[k - nChannels] + w1 * p[k] + w2 * p[k + nChannels]);
+}
+
+/**
+ * One output chunk from the three input rows around it and, for the
+ * separable and box strategies, their row passes h[0 … 2].
+ */
+template <typename Sum>
+[[gnu::always_inline]] inline void algebraic_chunk(const unsigned char *const rows[3], const Sum *const h[3],
+                                                   unsigned char *out, int i, int n, int nChannels,
+                                                   const AlgebraicPlan &plan)
+{
+    // apply_linear truncates S / 2^shift and clamps; for S ≥ 0 that is S >> shift.
+    const int shift = plan.shift;
+    unsigned char *o = out + i;
+
+    if (plan.strategy != KernelStrategy::Sparse)
+    {
+        const Sum c0 = Sum(plan.column[0]), c1 = Sum(plan.column[1]), c2 = Sum(plan.column[2]);
+        const Sum scale = Sum(plan.scale), center = Sum(plan.center);
+        const unsigned char *p = rows[1] + i;
+        for (int k = 0; k < n; k++)
+        {
+            const Sum sum = Sum(scale * Sum(c0 * h[0][k] + c1 * h[1][k] + c2 * h[2][k]) + center * p[k]);
+            const int v = sum >> shift;
+            o[k] = v < 0 ? 0 : v > 255 ? 255 : v;
+        }
+        return;
+    }
+
+    Sum acc[kAlgebraicChunk], group[kAlgebraicChunk];
+    if (!plan.groups)
+        std::fill(acc, acc + n, Sum(0));
+    for (int g = 0, begin = 0; g < plan.groups; begin = plan.group_end[g++])
+    {
+        auto tap = [&](int t)
+        { return rows[t / 3] + i + (t % 3 - 1) * nChannels; };
+
+        // A lone tap goes straight into the sum; shared taps are added first.
+        if (plan.group_end[g] - begin == 1)
+        {
+            add_tap(acc, tap(plan.taps[begin]), n, plan.group_weight[g], g == 0);
+            continue;
+        }
+        for (int j = begin; j < plan.group_end[g]; j++)
+            add_tap(group, tap(plan.taps[j]), n, 1, j == begin);
+        add_tap(acc, group, n, plan.group_weight[g], g == 0);
+    }
+    for (int k = 0; k < n; k++)
+    {
+        const int v = acc[k] >> shift;
+        o[k] = v < 0 ? 0 : v > 255 ? 255 : v;
+    }
+}
+
+/**
+ * Computes nRows output rows from rows[0 … nRows + 1] (the BlockKernel
+ * layout). Chunk by chunk, the row pass of every input row is computed once
+ * and kept in a ring of three, so it serves all output rows that use it.
+ */
+template <typename Sum>
+[[gnu::always_inline]] inline void algebraic_rows(const unsigned char *const *rows, unsigned char *const *out,
+                                                  int nRows, int width, int nChannels,
+                                                  const AlgebraicPlan &plan)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    const bool row_passes = plan.strategy != KernelStrategy::Sparse;
+    Sum ring[3][kAlgebraicChunk];
+
+    for (int i = begin; i < end; i += kAlgebraicChunk)
+    {
+        const int n = std::min(kAlgebraicChunk, end - i);
+        for (int j = 0; j < 2 && row_passes; j++)
+            algebraic_row_pass(rows[j], ring[j], i, n, nChannels, plan.row);
+
+        for (int r = 0; r < nRows; r++)
+        {
+            if (row_passes)
+                algebraic_row_pass(rows[r + 2], ring[(r + 2) % 3], i, n, nChannels, plan.row);
+            const Sum *h[3] = {ring[r % 3], ring[(r + 1) % 3], ring[(r + 2) % 3]};
+            const unsigned char *window[3] = {rows[r], rows[r + 1], rows[r + 2]};
+            algebraic_chunk(window, h, out[r], i, n, nChannels, plan);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void algebraic_block_avx2(const unsigned char *const *rows,
+                                                          unsigned char *const *out, int nRows, int width,
+                                                          int nChannels, const AlgebraicPlan &plan)
+{
+    if (plan.narrow)
+        algebraic_rows<int16_t>(rows, out, nRows, width, nChannels, plan);
+    else
+        algebraic_rows<int32_t>(rows, out, nRows, width, nChannels, plan);
+}
+
+__attribute__((target("avx512bw"))) void algebraic_block_avx512(const unsigned char *const *rows,
+                                                                unsigned char *const *out, int nRows, int width,
+                                                                int nChannels, const AlgebraicPlan &plan)
+{
+    if (plan.narrow)
+        algebraic_rows<int16_t>(rows, out, nRows, width, nChannels, plan);
+    else
+        algebraic_rows<int32_t>(rows, out, nRows, width, nChannels, plan);
+}
+
+void algebraic_block(const unsigned char *const *rows, unsigned char *const *out, int nRows,
+                     int width, int nChannels, const AlgebraicPlan &plan)
+{
+    static const bool avx512 = __builtin_cpu_supports("avx512bw");
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx512)
+        algebraic_block_avx512(rows, out, nRows, width, nChannels, plan);
+    else if (avx2)
+        algebraic_block_avx2(rows, out, nRows, width, nChannels, plan);
+    else if (plan.narrow)
+        algebraic_rows<int16_t>(rows, out, nRows, width, nChannels, plan);
+    else
+        algebraic_rows<int32_t>(rows, out, nRows, width, nChannels, plan);
+}
+
+/// Row‑kernel form for the streaming and in‑place paths; the plan is cached per kernel.
+void algebraic_row(const unsigned char *const rows[3], unsigned char *out,
+                   int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    thread_local bool planned = false;
+    thread_local float planned_for[3][3];
+    thread_local AlgebraicPlan plan;
+    if (!planned || std::memcmp(planned_for, kernel.data, sizeof(planned_for)) != 0)
+    {
+        plan = algebraic_plan(kernel.analyze());
+        std::memcpy(planned_for, kernel.data, sizeof(planned_for));
+        planned = true;
+    }
+
+    if (plan.strategy == KernelStrategy::Direct)
+        blocked_row(rows, out, width, nChannels, kernel);
+    else
+        algebraic_block(rows, &out, 1, width, nChannels, plan);
+}
+
+void Convolver::apply_algebraic(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    const AlgebraicPlan plan = algebraic_plan(kernel.analyze());
+    if (plan.strategy == KernelStrategy::Direct)
+        return apply_blocked(img, out, kernel);
+    check_views(img, out);
+
+    const unsigned char *rows[kAlgebraicBlockRows + 2];
+    unsigned char *outs[kAlgebraicBlockRows];
+    for (int band = 1; band < img.height - 1; band += kTraceBandRows)
+    {
+        CAR_TRACE_SCOPE("convolve_band", band);
+        const int band_end = std::min(band + kTraceBandRows, img.height - 1);
+
+        for (int y = band; y < band_end; y += kAlgebraicBlockRows)
+        {
+            const int n = std::min(kAlgebraicBlockRows, band_end - y);
+            for (int j = 0; j < n + 2; j++)
+                rows[j] = img.row(y - 1 + j);
+            for (int r = 0; r < n; r++)
+                outs[r] = out.row(y + r);
+            algebraic_block(rows, outs, n, img.width, img.nChannels, plan);
+        }
+    }
+}
+
+/**
+ * Compile‑time specializations (static_kernel.hpp), looked up by the exact
+ * weights of the runtime kernel; nullptr if there is none.
+ */
+RowKernel static_row_for(const ConvolutionKernel &kernel)
+{
+    struct Specialization
+    {
+        StaticKernel weights;
+        RowKernel row;
+    };
+    static constexpr Specialization specializations[] = {
+        {kEdgeKernel, StaticConvolution<kEdgeKernel>::row},
+        {kSharpenKernel, StaticConvolution<kSharpenKernel>::row},
+        {kBlurKernel, StaticConvolution<kBlurKernel>::row},
+    };
+
+    for (const Specialization &s : specializations)
+        if (std::memcmp(s.weights.data, kernel.data, sizeof(kernel.data)) == 0)
+            return s.row;
+    return nullptr;
+}
+
+/// Row‑kernel form for the streaming and in‑place paths.
+void static_row(const unsigned char *const rows[3], unsigned char *out,
+                int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    RowKernel row = static_row_for(kernel);
+    (row ? row : blocked_row)(rows, out, width, nChannels, kernel);
+}
+
+bool Convolver::has_static_kernel(const ConvolutionKernel &kernel)
+{
+    return static_row_for(kernel) != nullptr;
+}
+
+void Convolver::apply_static(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    RowKernel row = static_row_for(kernel);
+    if (!row)
+        return apply_blocked(img, out, kernel);
+    convolve_rows(img, out, kernel, row);
+}
+
+/**
+ * Winograd minimal filtering F(2×2, 3×3). A 4×4 input tile d gives a 2×2
+ * output tile Y = Aᵀ[(G g Gᵀ) ⊙ (Bᵀ d B)]A: the kernel transform U = G g Gᵀ is
+ * computed once, the data transform only adds and subtracts, and the 2×2
+ * outputs take 16 multiplies instead of 36. Single rows (odd strip heights,
+ * the in‑place path) use the one‑dimensional F(2, 3) along x for each kernel
+ * row, 12 multiplies per two outputs instead of 18.
+ *
+ * Tiles step two pixels, so each input row is split once per chunk into its
+ * even and odd pixels as floats; tap offsets then become contiguous
+ * (d0 = even[e], d1 = odd[e], d2 = even[e + nChannels], d3 = odd[e + nChannels])
+ * and the tile loops vectorize over channels and tiles alike. The split rows
+ * of a strip are kept in a ring of four, so every input row is split once.
+ * An odd interior width leaves one column, computed like apply_linear().
+ *
+ * Not bit‑exact: the transforms reorder the float sums, so a result that lands
+ * next to an integer may truncate one level differently (see bit_exact()).
+ */
+constexpr int kWinogradChunk = 128; ///< Tiles per chunk; the split ring stays in L1.
+/// Output rows per strip (even, so tile rows pair up).
+constexpr int kWinogradBlockRows = 16;
+
+struct WinogradPlan
+{
+    float u[4][4]; ///< G g Gᵀ for 2×2 tiles.
+    float v[3][4]; ///< G g_ky for each kernel row, for single rows.
+};
+
+WinogradPlan winograd_plan(const ConvolutionKernel &kernel)
+{
+    static constexpr double G[4][3] = {{1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+    WinogradPlan plan;
+    double gk[4][3]; // G g
+    for (int a = 0; a < 4; a++)
+        for (int x = 0; x < 3; x++)
+            gk[a][x] = G[a][0] * kernel.data[0][x] + G[a][1] * kernel.data[1][x] + G[a][2] * kernel.data[2][x];
+    for (int a = 0; a < 4; a++)
+        for (int b = 0; b < 4; b++)
+            plan.u[a][b] = float(gk[a][0] * G[b][0] + gk[a][1] * G[b][1] + gk[a][2] * G[b][2]);
+    for (int y = 0; y < 3; y++)
+        for (int b = 0; b < 4; b++)
+            plan.v[y][b] = float(kernel.data[y][0] * G[b][0] + kernel.data[y][1] * G[b][1] +
+                                 kernel.data[y][2] * G[b][2]);
+    return plan;
+}
+
+/**
+ * Byte shuffles between pixel pairs and their even / odd pixels: 16 bytes
+ * hold kTiles tiles (2 × kTiles pixels); split gathers their even pixels into
+ * bytes 0–7 and odd pixels into bytes 8–15, merge is the inverse.
+ */
+template <int NC>
+struct WinogradShuffle
+{
+    static constexpr int kTiles = 16 / (2 * NC);
+    static constexpr int kValues = kTiles * NC; ///< Bytes of each half (8, or 6 for RGB).
+
+    struct Mask
+    {
+        char bytes[16];
+    };
+
+    static constexpr Mask split()
+    {
+        Mask m{};
+        for (int i = 0; i < 16; i++)
+            m.bytes[i] = i % 8 < kValues ? char((i % 8) / NC * 2 * NC + (i / 8) * NC + (i % 8) % NC) : char(0x80);
+        return m;
+    }
+
+    static constexpr Mask merge()
+    {
+        Mask m{};
+        for (int q = 0; q < 16; q++)
+            m.bytes[q] = q < 2 * kValues ? char((q % (2 * NC)) / NC * 8 + q / (2 * NC) * NC + q % NC) : char(0x80);
+        return m;
+    }
+};
+
+/// Pixels 2t and 2t + 1 of tiles t0 … t0 + tiles − 1 as floats; reads stay below rowBytes.
+template <int NC>
+[[gnu::always_inline]] inline void winograd_split(const unsigned char *row, float *even, float *odd,
+                                                  int t0, int tiles, int rowBytes)
+{
+    using Shuffle = WinogradShuffle<NC>;
+    static constexpr typename Shuffle::Mask kSplit = Shuffle::split();
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(kSplit.bytes));
+    const unsigned char *p = row + 2 * t0 * NC;
+
+    // The last four floats of each half may be past kValues; the next step overwrites them.
+    int t = 0;
+    for (; t + Shuffle::kTiles <= tiles && 2 * (t0 + t) * NC + 16 <= rowBytes; t += Shuffle::kTiles)
+    {
+        const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 2 * t * NC)), mask);
+        _mm_storeu_ps(even + t * NC, _mm_cvtepi32_ps(_mm_cvtepu8_epi32(v)));
+        _mm_storeu_ps(even + t * NC + 4, _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4))));
+        _mm_storeu_ps(odd + t * NC, _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8))));
+        _mm_storeu_ps(odd + t * NC + 4, _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12))));
+    }
+    for (; t < tiles; t++)
+        for (int c = 0; c < NC; c++)
+        {
+            even[t * NC + c] = p[2 * t * NC + c];
+            odd[t * NC + c] = p[(2 * t + 1) * NC + c];
+        }
+}
+
+/// Writes the outputs of nt tiles, pixels 2t + 1 (y0) and 2t + 2 (y1), from pixel 2 t0 + 1 on.
+template <int NC>
+[[gnu::always_inline]] inline void winograd_merge(const unsigned char *y0, const unsigned char *y1,
+                                                  unsigned char *out, int t0, int nt)
+{
+    using Shuffle = WinogradShuffle<NC>;
+    static constexpr typename Shuffle::Mask kMerge = Shuffle::merge();
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(kMerge.bytes));
+    unsigned char *o = out + (2 * t0 + 1) * NC;
+
+    // Each store may spill past its tiles; those bytes are written again later.
+    int t = 0;
+    for (; 2 * t * NC + 16 <= 2 * nt * NC; t += Shuffle::kTiles)
+    {
+        const __m128i v = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(y0 + t * NC)),
+                                             _mm_loadl_epi64(reinterpret_cast<const __m128i *>(y1 + t * NC)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o + 2 * t * NC), _mm_shuffle_epi8(v, mask));
+    }
+    for (; t < nt; t++)
+        for (int c = 0; c < NC; c++)
+        {
+            o[2 * t * NC + c] = y0[t * NC + c];
+            o[(2 * t + 1) * NC + c] = y1[t * NC + c];
+        }
+}
+
+/// Bᵀ d along x for tile element e of one split row.
+[[gnu::always_inline]] inline void winograd_input(const float *even, const float *odd, int e, int nChannels,
+                                                  float h[4])
+{
+    const float d0 = even[e], d1 = odd[e], d2 = even[e + nChannels], d3 = odd[e + nChannels];
+    h[0] = d0 - d2;
+    h[1] = d1 + d2;
+    h[2] = d2 - d1;
+    h[3] = d1 - d3;
+}
+
+/// 2×2 tiles from four split rows; y[0], y[1] are the upper output row, y[2], y[3] the lower.
+template <int NC>
+[[gnu::always_inline]] inline void winograd_tiles(const float *const even[4], const float *const odd[4],
+                                                  unsigned char (*y)[kWinogradChunk * NC + 8], int n,
+                                                  const float u[4][4])
+{
+    for (int e = 0; e < n; e++)
+    {
+        float h[4][4];
+        for (int j = 0; j < 4; j++)
+            winograd_input(even[j], odd[j], e, NC, h[j]);
+        float s[2][4]; // Aᵀ M
+        for (int b = 0; b < 4; b++)
+        {
+            const float m0 = u[0][b] * (h[0][b] - h[2][b]);
+            const float m1 = u[1][b] * (h[1][b] + h[2][b]);
+            const float m2 = u[2][b] * (h[2][b] - h[1][b]);
+            const float m3 = u[3][b] * (h[1][b] - h[3][b]);
+            s[0][b] = m0 + m1 + m2;
+            s[1][b] = m1 - m2 - m3;
+        }
+        for (int r = 0; r < 2; r++)
+        {
+            y[2 * r][e] = std::clamp(s[r][0] + s[r][1] + s[r][2], 0.0f, 255.0f);
+            y[2 * r + 1][e] = std::clamp(s[r][1] - s[r][2] - s[r][3], 0.0f, 255.0f);
+        }
+    }
+}
+
+/// One output row from three split rows (F(2, 3) along x).
+template <int NC>
+[[gnu::always_inline]] inline void winograd_line(const float *const even[3], const float *const odd[3],
+                                                 unsigned char (*y)[kWinogradChunk * NC + 8], int n,
+                                                 const float v[3][4])
+{
+    for (int e = 0; e < n; e++)
+    {
+        float h[3][4];
+        for (int j = 0; j < 3; j++)
+            winograd_input(even[j], odd[j], e, NC, h[j]);
+        float m[4];
+        for (int b = 0; b < 4; b++)
+            m[b] = v[0][b] * h[0][b] + v[1][b] * h[1][b] + v[2][b] * h[2][b];
+        y[0][e] = std::clamp(m[0] + m[1] + m[2], 0.0f, 255.0f);
+        y[1][e] = std::clamp(m[1] - m[2] - m[3], 0.0f, 255.0f);
+    }
+}
+
+/**
+ * nRows output rows (up to kWinogradBlockRows) from rows[0 … nRows + 1]:
+ * pairs of rows as 2×2 tiles, a last odd row with F(2, 3).
+ */
+template <int NC>
+[[gnu::always_inline]] inline void winograd_rows(const unsigned char *const *rows, unsigned char *const *out,
+                                                 int nRows, int width, const ConvolutionKernel &kernel,
+                                                 const WinogradPlan &plan)
+{
+    constexpr int kSplit = (kWinogradChunk + 1) * NC + 8;
+    const int tiles = (width - 2) / 2;
+    const int rowBytes = width * NC;
+    float even[4][kSplit], odd[4][kSplit]; // input row j in slot j % 4
+    unsigned char y[4][kWinogradChunk * NC + 8];
+    float u[4][4], v[3][4];
+    std::memcpy(u, plan.u, sizeof(u));
+    std::memcpy(v, plan.v, sizeof(v));
+
+    for (int t0 = 0; t0 < tiles; t0 += kWinogradChunk)
+    {
+        const int nt = std::min(kWinogradChunk, tiles - t0);
+        const int n = nt * NC;
+        auto split = [&](int j) { winograd_split<NC>(rows[j], even[j % 4], odd[j % 4], t0, nt + 1, rowBytes); };
+        split(0);
+        split(1);
+
+        for (int r = 0; r < nRows; r += 2)
+        {
+            split(r + 2);
+            if (r + 1 < nRows)
+            {
+                split(r + 3);
+                const float *e4[4] = {even[r % 4], even[(r + 1) % 4], even[(r + 2) % 4], even[(r + 3) % 4]};
+                const float *o4[4] = {odd[r % 4], odd[(r + 1) % 4], odd[(r + 2) % 4], odd[(r + 3) % 4]};
+                winograd_tiles<NC>(e4, o4, y, n, u);
+                winograd_merge<NC>(y[0], y[1], out[r], t0, nt);
+                winograd_merge<NC>(y[2], y[3], out[r + 1], t0, nt);
+            }
+            else
+            {
+                const float *e3[3] = {even[r % 4], even[(r + 1) % 4], even[(r + 2) % 4]};
+                const float *o3[3] = {odd[r % 4], odd[(r + 1) % 4], odd[(r + 2) % 4]};
+                winograd_line<NC>(e3, o3, y, n, v);
+                winograd_merge<NC>(y[0], y[1], out[r], t0, nt);
+            }
+        }
+    }
+
+    if ((width - 2) % 2)
+        for (int r = 0; r < nRows; r++)
+        {
+            const unsigned char *window[3] = {rows[r], rows[r + 1], rows[r + 2]};
+            do_scalar_pixel(width - 2, window, out[r], NC, kernel);
+        }
+}
+
+[[gnu::always_inline]] inline void winograd_dispatch(const unsigned char *const *rows, unsigned char *const *out,
+                                                     int nRows, int width, int nChannels,
+                                                     const ConvolutionKernel &kernel, const WinogradPlan &plan)
+{
+    switch (nChannels)
+    {
+    case 1:
+        return winograd_rows<1>(rows, out, nRows, width, kernel, plan);
+    case 2:
+        return winograd_rows<2>(rows, out, nRows, width, kernel, plan);
+    case 3:
+        return winograd_rows<3>(rows, out, nRows, width, kernel, plan);
+    default:
+        return winograd_rows<4>(rows, out, nRows, width, kernel, plan);
+    }
+}
+
+__attribute__((target("avx2"))) void winograd_block_avx2(const unsigned char *const *rows, unsigned char *const *out,
+                                                         int nRows, int width, int nChannels,
+                                                         const ConvolutionKernel &kernel, const WinogradPlan &plan)
+{
+    winograd_dispatch(rows, out, nRows, width, nChannels, kernel, plan);
+}
+
+__attribute__((target("avx512bw"))) void winograd_block_avx512(const unsigned char *const *rows,
+                                                              unsigned char *const *out, int nRows, int width,
+                                                              int nChannels, const ConvolutionKernel &kernel,
+                                                              const WinogradPlan &plan)
+{
+    winograd_dispatch(rows, out, nRows, width, nChannels, kernel, plan);
+}
+
+void winograd_block(const unsigned char *const *rows, unsigned char *const *out, int nRows,
+                    int width, int nChannels, const ConvolutionKernel &kernel, const WinogradPlan &plan)
+{
+    static const bool avx512 = __builtin_cpu_supports("avx512bw");
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx512)
+        winograd_block_avx512(rows, out, nRows, width, nChannels, kernel, plan);
+    else if (avx2)
+        winograd_block_avx2(rows, out, nRows, width, nChannels, kernel, plan);
+    else
+        winograd_dispatch(rows, out, nRows, width, nChannels, kernel, plan);
+}
+
+/// Row‑kernel form (one‑dimensional F(2, 3)) for the streaming and in‑place paths.
+void winograd_row(const unsigned char *const rows[3], unsigned char *out,
+                  int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    thread_local bool planned = false;
+    thread_local float planned_for[3][3];
+    thread_local WinogradPlan plan;
+    if (!planned || std::memcmp(planned_for, kernel.data, sizeof(planned_for)) != 0)
+    {
+        plan = winograd_plan(kernel);
+        std::memcpy(planned_for, kernel.data, sizeof(planned_for));
+        planned = true;
+    }
+    winograd_block(rows, &out, 1, width, nChannels, kernel, plan);
+}
+
+void Convolver::apply_winograd(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    check_views(img, out);
+    const WinogradPlan plan = winograd_plan(kernel);
+
+    const unsigned char *rows[kWinogradBlockRows + 2];
+    unsigned char *outs[kWinogradBlockRows];
+    for (int band = 1; band < img.height - 1; band += kTraceBandRows)
+    {
+        CAR_TRACE_SCOPE("convolve_band", band);
+        const int band_end = std::min(band + kTraceBandRows, img.height - 1);
+
+        for (int y = band; y < band_end; y += kWinogradBlockRows)
+        {
+            const int n = std::min(kWinogradBlockRows, band_end - y);
+            for (int j = 0; j < n + 2; j++)
+                rows[j] = img.row(y - 1 + j);
+            for (int r = 0; r < n; r++)
+                outs[r] = out.row(y + r);
+            winograd_block(rows, outs, n, img.width, img.nChannels, kernel, plan);
+        }
+    }
+}
+
+/**
+ * Runs a generated row loop over the interior bytes; as in the other kernels
+ * the last block is shifted back instead of a scalar tail.
+ */
+void jit_run(KernelJit::RowFunction fn, const unsigned char *const rows[3], unsigned char *out,
+             int width, int nChannels)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    const long blocks = (end - begin) / KernelJit::kBlockBytes;
+    fn(rows[0] + begin, rows[1] + begin, rows[2] + begin, out + begin, blocks);
+
+    const int tail = end - KernelJit::kBlockBytes;
+    if ((end - begin) % KernelJit::kBlockBytes)
+        fn(rows[0] + tail, rows[1] + tail, rows[2] + tail, out + tail, 1);
+}
+
+/// Row‑kernel form for the streaming and in‑place paths.
+void jit_row(const unsigned char *const rows[3], unsigned char *out,
+             int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    thread_local KernelJit::RowFunction fn = nullptr;
+    thread_local float compiled_for[3][3];
+    thread_local int compiled_channels = 0;
+    if (compiled_channels != nChannels || std::memcmp(compiled_for, kernel.data, sizeof(compiled_for)) != 0)
+    {
+        fn = KernelJit::compile(kernel, nChannels);
+        std::memcpy(compiled_for, kernel.data, sizeof(compiled_for));
+        compiled_channels = nChannels;
+    }
+
+    if (!fn)
+        blocked_row(rows, out, width, nChannels, kernel);
+    else if ((width - 2) * nChannels < KernelJit::kBlockBytes)
+        linear_row(rows, out, width, nChannels, kernel);
+    else
+        jit_run(fn, rows, out, width, nChannels);
+}
+
+void Convolver::apply_jit(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    if (!KernelJit::compile(kernel, img.nChannels))
+        return apply_blocked(img, out, kernel);
+    convolve_rows(img, out, kernel, jit_row);
+}
+
+/**
+ * Original load stage of apply_simd: 12 scalar byte reads and three
+ * _mm_set_ps per tap. Kept as the "simd-gather" backend for comparison.
+ */
+void simd_gather_row(const unsigned char *const rows[3], unsigned char *out,
+                     int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    if (nChannels != 3)
+    {
+        bytestream_row(rows, out, width, nChannels, kernel);
+        return;
+    }
+
+    // Last x at which a 4‑pixel block still ends inside the interior. The final
+    // block of each row is shifted back to start there (recomputing a few pixels)
+    // so there is no scalar tail; narrower images use the scalar code.
+    const int lastBlockX = width - 1 - 4;
+    if (lastBlockX < 1)
+    {
+        linear_row(rows, out, width, nChannels, kernel);
+        return;
+    }
+
+    for (int blockX = 1; blockX < width - 1; blockX += 4)
+    {
+        const int imageX = std::min(blockX, lastBlockX);
+
+        __m128 sumR = _mm_setzero_ps();
+        __m128 sumG = _mm_setzero_ps();
+        __m128 sumB = _mm_setzero_ps();
+
+        // ITERATE OVER KERNEL
+        for (int kernelY = -1; kernelY <= 1; kernelY++)
+        {
+            for (int kernelX = -1; kernelX <= 1; kernelX++)
+            {
+                float currentKernelWeight = kernel.data[kernelY + 1][kernelX + 1];
+                __m128 vectorizedWeight = _mm_set1_ps(currentKernelWeight);
+
+                const unsigned char *ptr = rows[kernelY + 1] + (imageX + kernelX) * nChannels;
+
+                float r0 = ptr[0];
+                float g0 = ptr[1];
+                float b0 = ptr[2];
+
+                float r1 = ptr[3];
+                float g1 = ptr[4];
+                float b1 = ptr[5];
+
+                float r2 = ptr[6];
+                float g2 = ptr[7];
+                float b2 = ptr[8];
+
+                float r3 = ptr[9];
+                float g3 = ptr[10];
+                float b3 = ptr[11];
+
+                __m128 R = _mm_set_ps(r3, r2, r1, r0);
+                __m128 G = _mm_set_ps(g3, g2, g1, g0);
+                __m128 B = _mm_set_ps(b3, b2, b1, b0);
+
+                sumR = _mm_add_ps(sumR, _mm_mul_ps(R, vectorizedWeight));
+                sumG = _mm_add_ps(sumG, _mm_mul_ps(G, vectorizedWeight));
+                sumB = _mm_add_ps(sumB, _mm_mul_ps(B, vectorizedWeight));
+            }
+        }
+
+        __m128i r32 = _mm_cvttps_epi32(sumR);
+        __m128i g32 = _mm_cvttps_epi32(sumG);
+        __m128i b32 = _mm_cvttps_epi32(sumB);
+
+        alignas(16) int r[4], g[4], b[4];
+        _mm_store_si128((__m128i *)r, r32);
+        _mm_store_si128((__m128i *)g, g32);
+        _mm_store_si128((__m128i *)b, b32);
+
+        uint8_t *outputPtr = out + imageX * nChannels;
+
+        for (int i = 0; i < 4; i++)
+        {
+            outputPtr[i * 3 + 0] = std::clamp(r[i], 0, 255);
+            outputPtr[i * 3 + 1] = std::clamp(g[i], 0, 255);
+            outputPtr[i * 3 + 2] = std::clamp(b[i], 0, 255);
+        }
+    }
+}
+
+/**
+ * Shuffle‑based load stage: one 16‑byte load per tap row covers the 12 bytes
+ * of 4 RGB pixels (the rest is row slack, see Image::kRowSlack). pshufb
+ * gathers each channel into the low four bytes and _mm_cvtepu8_epi32 widens
+ * them, replacing 12 scalar reads and three _mm_set_ps per tap. The values,
+ * and therefore the results, are identical to simd_gather_row.
+ *
+ * The epilogue packs the three sums with saturation, re‑interleaves R/G/B
+ * with one more pshufb and writes the 4 pixels with a single store.
+ */
+void simd_row(const unsigned char *const rows[3], unsigned char *out,
+              int width, int nChannels, const ConvolutionKernel &kernel)
+{
+    // The shuffles below are specific to RGB; other layouts use the
+    // channel‑agnostic byte‑stream kernel.
+    if (nChannels != 3)
+    {
+        bytestream_row(rows, out, width, nChannels, kernel);
+        return;
+    }
+
+    const int lastBlockX = width - 1 - 4;
+    if (lastBlockX < 1)
+    {
+        linear_row(rows, out, width, nChannels, kernel);
+        return;
+    }
+
+    const __m128i splitR = _mm_setr_epi8(0, 3, 6, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i splitG = _mm_setr_epi8(1, 4, 7, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i splitB = _mm_setr_epi8(2, 5, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i interleave = _mm_setr_epi8(0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11, -1, -1, -1, -1);
+
+    __m128 weights[3][3];
+    for (int ky = 0; ky < 3; ky++)
+        for (int kx = 0; kx < 3; kx++)
+            weights[ky][kx] = _mm_set1_ps(kernel.data[ky][kx]);
+
+    for (int blockX = 1; blockX < width - 1; blockX += 4)
+    {
+        const int imageX = std::min(blockX, lastBlockX);
+
+        __m128 sumR = _mm_setzero_ps();
+        __m128 sumG = _mm_setzero_ps();
+        __m128 sumB = _mm_setzero_ps();
+
+        for (int ky = 0; ky < 3; ky++)
+        {
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const unsigned char *ptr = rows[ky] + (imageX + kx - 1) * nChannels;
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+
+                __m128 R = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_shuffle_epi8(pixels, splitR)));
+                __m128 G = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_shuffle_epi8(pixels, splitG)));
+                __m128 B = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_shuffle_epi8(pixels, splitB)));
+
+                sumR = _mm_add_ps(sumR, _mm_mul_ps(R, weights[ky][kx]));
+                sumG = _mm_add_ps(sumG, _mm_mul_ps(G, weights[ky][kx]));
+                sumB = _mm_add_ps(sumB, _mm_mul_ps(B, weights[ky][kx]));
+            }
+        }
+
+        // Saturating packs clamp to [0, 255] exactly like std::clamp on the
+        // truncated ints: int32 -> int16 (signed saturation) -> uint8.
+        __m128i rg16 = _mm_packs_epi32(_mm_cvttps_epi32(sumR), _mm_cvttps_epi32(sumG));
+        __m128i b16 = _mm_packs_epi32(_mm_cvttps_epi32(sumB), _mm_setzero_si128());
+        __m128i planar = _mm_packus_epi16(rg16, b16); // r0..r3 g0..g3 b0..b3 0 0 0 0
+        __m128i rgb = _mm_shuffle_epi8(planar, interleave);
+
+        uint8_t *outputPtr = out + imageX * nChannels;
+        if (imageX * 3 + 16 <= (width - 1) * 3)
+        {
+            // The 4 bytes past the block are rewritten by the next block.
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(outputPtr), rgb);
+        }
+        else
+        {
+            // Near the right border: store exactly 12 bytes.
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(outputPtr), rgb);
+            int last4 = _mm_extract_epi32(rgb, 2);
+            std::memcpy(outputPtr + 8, &last4, sizeof(last4));
+        }
+    }
+}
+
+void Convolver::apply_simd(ConstImageView img, ImageView out, const ConvolutionKernel &kernel)
+{
+    convolve_rows(img, out, kernel, simd_row);
+}
+
+RowKernel row_kernel_for(Backend backend)
+{
+    switch (backend)
+    {
+    case Backend::Simd:
+        return simd_row;
+    case Backend::SimdGather:
+        return simd_gather_row;
+    case Backend::ByteStream:
+        return bytestream_row;
+    case Backend::Blocked:
+        return blocked_row;
+    case Backend::Fma:
+        return fma_row_kernel;
+    case Backend::Algebraic:
+        return algebraic_row;
+    case Backend::Static:
+        return static_row;
+    case Backend::Jit:
+        return jit_row;
+    case Backend::Winograd:
+        return winograd_row;
+    default:
+        return linear_row;
+    }
+}
+
+/**
+ * Half‑precision row kernels. Channels are interleaved, so a horizontal tap is
+ * a shift of ±nChannels elements and the row is processed as a flat stream of
+ * elements (nChannels … (width − 1) × nChannels).
+ */
+void half_row_scalar(const uint16_t *const rows[3], uint16_t *out, int begin, int end,
+                     int nChannels, const ConvolutionKernel &kernel)
+{
+    for (int i = begin; i < end; i++)
+    {
+        float acc = 0;
+        for (int ky = 0; ky < 3; ky++)
+            for (int kx = 0; kx < 3; kx++)
+                acc += HalfImage::half_to_float(rows[ky][i + (kx - 1) * nChannels]) * kernel.data[ky][kx];
+        out[i] = HalfImage::float_to_half(acc);
+    }
+}
+
+__attribute__((target("avx,f16c"))) void half_row_f16c(const uint16_t *const rows[3], uint16_t *out,
+                                                       int width, int nChannels,
+                                                       const ConvolutionKernel &kernel)
+{
+    const int begin = nChannels;
+    const int end = (width - 1) * nChannels;
+    if (end - begin < 8)
+    {
+        half_row_scalar(rows, out, begin, end, nChannels, kernel);
+        return;
+    }
+
+    __m256 weights[3][3];
+    for (int ky = 0; ky < 3; ky++)
+        for (int kx = 0; kx < 3; kx++)
+            weights[ky][kx] = _mm256_set1_ps(kernel.data[ky][kx]);
+
+    // As in simd_row, the last block is shifted back instead of a scalar tail.
+    for (int block = begin; block < end; block += 8)
+    {
+        const int i = std::min(block, end - 8);
+        __m256 acc = _mm256_setzero_ps();
+        for (int ky = 0; ky < 3; ky++)
+            for (int kx = 0; kx < 3; kx++)
+            {
+                const uint16_t *p = rows[ky] + i + (kx - 1) * nChannels;
+                __m256 v = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(v, weights[ky][kx]));
+            }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                         _mm256_cvtps_ph(acc, _MM_FROUND_TO_NEAREST_INT));
+    }
+}
+
+void Convolver::apply_half(const HalfImage &img, HalfImage &out, const ConvolutionKernel &kernel)
+{
+    if (img.nChannels < 1 || img.nChannels > 4)
+        throw std::runtime_error("Unsupported channel count for convolution");
+
+    CAR_TRACE_SCOPE("convolve_half");
+    out.reshape(img.width, img.height, img.nChannels);
+    const size_t row_bytes = size_t(img.width) * img.nChannels * sizeof(uint16_t);
+    for (int y = 0; y < img.height; y++)
+    {
+        if (y == 0 || y == img.height - 1 || img.width <= 2)
+        {
+            std::memset(out.row(y), 0, row_bytes);
+            continue;
+        }
+
+        uint16_t *o = out.row(y);
+        std::fill(o, o + img.nChannels, 0);
+        std::fill(o + (img.width - 1) * img.nChannels, o + img.width * img.nChannels, 0);
+
+        const uint16_t *rows[3] = {img.row(y - 1), img.row(y), img.row(y + 1)};
+        if (HalfImage::f16c_supported())
+            half_row_f16c(rows, o, img.width, img.nChannels, kernel);
+        else
+            half_row_scalar(rows, o, img.nChannels, (img.width - 1) * img.nChannels,
+                            img.nChannels, kernel);
+    }
+}
+
+void Convolver::apply_in_place(Image &img, const ConvolutionKernel &kernel, Backend backend)
+{
+    apply_in_place(img.view(), kernel, backend);
+    clear_border(img);
+}
+
+void Convolver::apply_in_place(ImageView img, const ConvolutionKernel &kernel, Backend backend)
+{
+    if (img.nChannels < 1 || img.nChannels > 4)
+        throw std::runtime_error("Unsupported channel count for convolution");
+    if (img.height < 3)
+        return;
+
+    CAR_TRACE_SCOPE("convolve_in_place");
+    RowKernel row_kernel = row_kernel_for(backend);
+
+    // Rows y − 1 and y are overwritten before output row y + 1 needs them, so
+    // their original pixels are kept in two padded lines; row y + 1 is still
+    // untouched in the image and read in place.
+    const size_t row_bytes = size_t(img.width) * img.nChannels;
+    const int line_stride = Image::stride_for(img.width, img.nChannels);
+    PixelBuffer lines(2 * size_t(line_stride));
+    unsigned char *above = lines.data();
+    unsigned char *current = lines.data() + line_stride;
+
+    std::memcpy(above, img.row(0), row_bytes);
+    for (int y = 1; y < img.height - 1; y++)
+    {
+        std::memcpy(current, img.row(y), row_bytes);
+        const unsigned char *rows[3] = {above, current, img.row(y + 1)};
+        row_kernel(rows, img.row(y), img.width, img.nChannels, kernel);
+        std::swap(above, current);
+    }
 }
@@ -0,0 +1,161 @@
+#include <CAR-practica2/fft.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    // Explicit products: std::complex's operator* checks for inf / NaN and
+    // calls into libgcc, which keeps the butterflies from vectorizing.
+    inline float mul_re(Fft::Complex a, Fft::Complex b) { return a.real() * b.real() - a.imag() * b.imag(); }
+    inline float mul_im(Fft::Complex a, Fft::Complex b) { return a.real() * b.imag() + a.imag() * b.real(); }
+
+    /**
+     * Transforms all n columns of an n × n array at once: each butterfly
+     * combines two whole rows, so the inner loop is contiguous and vectorizes.
+     */
+    [[gnu::always_inline]] inline void fft_columns(Fft::Complex *data, int n, const int *reversed,
+                                                   const Fft::Complex *twiddles, bool inverse)
+    {
+        for (int y = 0; y < n; y++)
+            if (y < reversed[y])
+                std::swap_ranges(data + size_t(y) * n, data + size_t(y + 1) * n, data + size_t(reversed[y]) * n);
+
+        const float sign = inverse ? -1.0f : 1.0f;
+        for (int half = 1; half < n; half <<= 1)
+        {
+            const int step = n / (2 * half);
+            for (int start = 0; start < n; start += 2 * half)
+                for (int k = 0; k < half; k++)
+                {
+                    const float wr = twiddles[k * step].real(), wi = sign * twiddles[k * step].imag();
+                    float *a = reinterpret_cast<float *>(data + size_t(start + k) * n);
+                    float *b = reinterpret_cast<float *>(data + size_t(start + k + half) * n);
+                    for (int x = 0; x < 2 * n; x += 2)
+                    {
+                        const float tr = b[x] * wr - b[x + 1] * wi;
+                        const float ti = b[x] * wi + b[x + 1] * wr;
+                        const float ur = a[x], ui = a[x + 1];
+                        a[x] = ur + tr;
+                        a[x + 1] = ui + ti;
+                        b[x] = ur - tr;
+                        b[x + 1] = ui - ti;
+                    }
+                }
+        }
+
+        if (inverse)
+        {
+            const float scale = 1.0f / n;
+            float *f = reinterpret_cast<float *>(data);
+            for (size_t i = 0; i < size_t(n) * n * 2; i++)
+                f[i] *= scale;
+        }
+    }
+
+    __attribute__((target("avx2"))) void columns_avx2(Fft::Complex *data, int n, const int *reversed,
+                                                      const Fft::Complex *twiddles, bool inverse)
+    {
+        fft_columns(data, n, reversed, twiddles, inverse);
+    }
+
+    __attribute__((target("avx512f"))) void columns_avx512(Fft::Complex *data, int n, const int *reversed,
+                                                           const Fft::Complex *twiddles, bool inverse)
+    {
+        fft_columns(data, n, reversed, twiddles, inverse);
+    }
+}
+
+Fft::Fft(int size) : n(size)
+{
+    if (!is_power_of_two(size))
+        throw std::runtime_error("FFT size must be a power of two");
+    while ((1 << log2n) < n)
+        log2n++;
+
+    twiddles.resize(n / 2);
+    for (int k = 0; k < n / 2; k++)
+    {
+        const double angle = -2.0 * M_PI * k / n;
+        twiddles[k] = Complex(float(std::cos(angle)), float(std::sin(angle)));
+    }
+
+    reversed.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        int r = 0;
+        for (int b = 0; b < log2n; b++)
+            r |= ((i >> b) & 1) << (log2n - 1 - b);
+        reversed[i] = r;
+    }
+}
+
+int Fft::next_power_of_two(int n)
+{
+    int p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+void Fft::transform(Complex *data, bool inverse) const
+{
+    for (int i = 0; i < n; i++)
+        if (i < reversed[i])
+            std::swap(data[i], data[reversed[i]]);
+
+    // Conjugated twiddles give the inverse transform.
+    const float sign = inverse ? -1.0f : 1.0f;
+    for (int half = 1; half < n; half <<= 1)
+    {
+        const int step = n / (2 * half);
+        for (int start = 0; start < n; start += 2 * half)
+            for (int k = 0; k < half; k++)
+            {
+                const Complex w(twiddles[k * step].real(), sign * twiddles[k * step].imag());
+                const Complex u = data[start + k], v = data[start + k + half];
+                const Complex t(mul_re(v, w), mul_im(v, w));
+                data[start + k] = u + t;
+                data[start + k + half] = u - t;
+            }
+    }
+
+    if (inverse)
+    {
+        const float scale = 1.0f / n;
+        for (int i = 0; i < n; i++)
+            data[i] *= scale;
+    }
+}
+
+void Fft::transform_2d(Complex *data, bool inverse) const
+{
+    // Rows are transformed as columns of the transpose.
+    columns(data, inverse);
+    transpose(data);
+    columns(data, inverse);
+    transpose(data);
+}
+
+void Fft::transpose(Complex *data) const
+{
+    constexpr int kBlock = 16;
+    for (int by = 0; by < n; by += kBlock)
+        for (int bx = by; bx < n; bx += kBlock)
+            for (int y = by; y < std::min(by + kBlock, n); y++)
+                for (int x = std::max(bx, y + 1); x < std::min(bx + kBlock, n); x++)
+                    std::swap(data[size_t(y) * n + x], data[size_t(x) * n + y]);
+}
+
+void Fft::columns(Complex *data, bool inverse) const
+{
+    static const bool avx512 = __builtin_cpu_supports("avx512f");
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx512)
+        columns_avx512(data, n, reversed.data(), twiddles.data(), inverse);
+    else if (avx2)
+        columns_avx2(data, n, reversed.data(), twiddles.data(), inverse);
+    else
+        fft_columns(data, n, reversed.data(), twiddles.data(), inverse);
+}
@@ -0,0 +1,184 @@
+#include <CAR-practica2/half_image.hpp>
+#include <immintrin.h>
+#include <cstring>
+
+namespace
+{
+    __attribute__((target("avx,f16c"))) void to_float_f16c(const uint16_t *src, float *dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+        for (; i < n; i++)
+            dst[i] = HalfImage::half_to_float(src[i]);
+    }
+
+    __attribute__((target("avx,f16c"))) void from_float_f16c(const float *src, uint16_t *dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                             _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+        for (; i < n; i++)
+            dst[i] = HalfImage::float_to_half(src[i]);
+    }
+
+    // Bytes to halves, 8 at a time: widen, convert to float, narrow to half.
+    __attribute__((target("avx2,f16c"))) void bytes_to_half_f16c(const unsigned char *src, uint16_t *dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i));
+            __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+        }
+        for (; i < n; i++)
+            dst[i] = HalfImage::float_to_half(src[i]);
+    }
+
+    bool avx2_supported()
+    {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+}
+
+HalfImage::HalfImage(int width, int height, int nChannels)
+    : width(width), height(height), nChannels(nChannels),
+      stride(stride_for(width, nChannels)),
+      data(size_t(stride) * height * sizeof(uint16_t)) {}
+
+void HalfImage::reshape(int w, int h, int c)
+{
+    const int new_stride = stride_for(w, c);
+    const size_t needed = size_t(new_stride) * h * sizeof(uint16_t);
+    if (data.size() < needed)
+        data = PixelBuffer(needed);
+    width = w;
+    height = h;
+    nChannels = c;
+    stride = new_stride;
+}
+
+int HalfImage::stride_for(int width, int channels)
+{
+    int elements = width * channels;
+    return (elements + kRowAlignment - 1) / kRowAlignment * kRowAlignment;
+}
+
+float HalfImage::get(int x, int y, int channel) const
+{
+    return half_to_float(row(y)[x * nChannels + channel]);
+}
+
+void HalfImage::set(int x, int y, int channel, float value)
+{
+    row(y)[x * nChannels + channel] = float_to_half(value);
+}
+
+HalfImage HalfImage::from_image(const Image &img)
+{
+    HalfImage half(img.width, img.height, img.nChannels);
+    const size_t n = size_t(img.width) * img.nChannels;
+    for (int y = 0; y < img.height; y++)
+    {
+        if (f16c_supported() && avx2_supported())
+        {
+            bytes_to_half_f16c(img.row(y), half.row(y), n);
+            continue;
+        }
+        for (size_t i = 0; i < n; i++)
+            half.row(y)[i] = float_to_half(img.row(y)[i]);
+    }
+    return half;
+}
+
+void HalfImage::to_image(Image &out) const
+{
+    out.reshape(width, height, nChannels);
+    const size_t n = size_t(width) * nChannels;
+    PixelBuffer line(n * sizeof(float));
+    float *values = reinterpret_cast<float *>(line.data());
+    for (int y = 0; y < height; y++)
+    {
+        to_float(row(y), values, n);
+        for (size_t i = 0; i < n; i++)
+            out.row(y)[i] = std::clamp(values[i], 0.0f, 255.0f);
+    }
+}
+
+bool HalfImage::f16c_supported()
+{
+    static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    return supported;
+}
+
+void HalfImage::to_float(const uint16_t *src, float *dst, size_t n)
+{
+    if (f16c_supported())
+        return to_float_f16c(src, dst, n);
+    for (size_t i = 0; i < n; i++)
+        dst[i] = half_to_float(src[i]);
+}
+
+void HalfImage::from_float(const float *src, uint16_t *dst, size_t n)
+{
+    if (f16c_supported())
+        return from_float_f16c(src, dst, n);
+    for (size_t i = 0; i < n; i++)
+        dst[i] = float_to_half(src[i]);
+}
+
+float HalfImage::half_to_float(uint16_t h)
+{
+    const uint32_t sign = uint32_t(h & 0x8000) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1f;
+    const uint32_t mantissa = h & 0x3ff;
+
+    uint32_t bits;
+    if (exponent == 0x1f) // infinity / NaN (quieted, like vcvtph2ps)
+        bits = sign | 0x7f800000 | (mantissa ? 0x400000 | (mantissa << 13) : 0);
+    else if (exponent != 0) // normal: rebias 15 -> 127
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    else // zero / subnormal: mantissa × 2^-24 is exact in float
+    {
+        float value = mantissa * (1.0f / 16777216.0f);
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits |= sign;
+    }
+
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+uint16_t HalfImage::float_to_half(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    const uint16_t sign = uint16_t((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7fffffff;
+
+    if (magnitude >= 0x7f800000) // infinity / NaN (quieted, like vcvtps2ph)
+        return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 | ((magnitude >> 13) & 0x3ff) : 0);
+    if (magnitude >= 0x477ff000) // rounds to 65536 or more
+        return sign | 0x7c00;
+
+    if (magnitude < 0x38800000) // below 2^-14: half subnormal or zero
+    {
+        // Adding 0.5f aligns the value to the subnormal ulp (2^-24); the FPU
+        // performs the round‑to‑nearest‑even.
+        float shifted;
+        std::memcpy(&shifted, &magnitude, sizeof(shifted));
+        shifted += 0.5f;
+        uint32_t rounded;
+        std::memcpy(&rounded, &shifted, sizeof(rounded));
+        return sign | uint16_t(rounded - 0x3f000000);
+    }
+
+    // Rebias the exponent (127 -> 15) and round the 13 dropped bits to even.
+    const uint32_t odd = (magnitude >> 13) & 1;
+    magnitude += 0xc8000fff + odd;
+    return sign | uint16_t(magnitude >> 13);
+}
@@ -1,12 +1,89 @@
 #include <CAR-practica2/image.hpp>
+// Route stb's decode/encode buffers through the pool as well.
+#define STBI_MALLOC(sz) BufferPool::local().allocate(sz)
+#define STBI_REALLOC(p, newsz) BufferPool::local().reallocate(p, newsz)
+#define STBI_FREE(p) BufferPool::local().release(p)
 #define STB_IMAGE_IMPLEMENTATION
 #include <CAR-practica2/stb_image.h>
+#define STBIW_MALLOC(sz) BufferPool::local().allocate(sz)
+#define STBIW_REALLOC(p, newsz) BufferPool::local().reallocate(p, newsz)
+#define STBIW_FREE(p) BufferPool::local().release(p)
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <CAR-practica2/stb_image_write.h>
+#include <CAR-practica2/trace.hpp>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    void append_to_buffer(void *context, void *data, int size)
+    {
+        auto *buffer = static_cast<PooledBytes *>(context);
+        auto *bytes = static_cast<unsigned char *>(data);
+        buffer->insert(buffer->end(), bytes, bytes + size);
+    }
+
+    /// Encodes to memory first so encoding and file I/O show up separately in traces.
+    void write_jpg(const std::string &path, int width, int height,
+                   const unsigned char *rgb, int quality)
+    {
+        PooledBytes encoded;
+        encoded.reserve(size_t(width) * height); // JPEG output rarely exceeds 1 byte/pixel
+        {
+            CAR_TRACE_SCOPE("encode");
+            if (!stbi_write_jpg_to_func(append_to_buffer, &encoded, width, height, 3, rgb, quality))
+                throw std::runtime_error("Failed to encode: " + path);
+        }
+
+        CAR_TRACE_SCOPE("write");
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(encoded.data()), encoded.size());
+        if (!out)
+            throw std::runtime_error("Failed to write: " + path);
+    }
+}
 
 Image::Image(int width, int height, int nChannels)
     : width(width), height(height), nChannels(nChannels),
-      data(width * height * nChannels) {}
+      stride(stride_for(width, nChannels)),
+      data(size_t(stride) * height) {}
+
+void Image::reshape(int w, int h, int c)
+{
+    const int new_stride = stride_for(w, c);
+    const size_t needed = size_t(new_stride) * h;
+    if (data.size() < needed)
+        data = PixelBuffer(needed);
+    width = w;
+    height = h;
+    nChannels = c;
+    stride = new_stride;
+}
+
+int Image::stride_for(int width, int channels)
+{
+    int bytes = width * channels + kRowSlack;
+    return (bytes + kRowAlignment - 1) / kRowAlignment * kRowAlignment;
+}
+
+ImageView Image::view(int x, int y, int w, int h)
+{
+    if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > width || y + h > height)
+        throw std::out_of_range("Image view outside the image");
+    return {data.data() + size_t(y) * stride + x * nChannels, w, h, stride, nChannels};
+}
+
+ConstImageView Image::view(int x, int y, int w, int h) const
+{
+    return const_cast<Image *>(this)->view(x, y, w, h);
+}
+
+void Image::copy_packed(unsigned char *dst) const
+{
+    const size_t row_bytes = size_t(width) * nChannels;
+    for (int y = 0; y < height; y++)
+        std::memcpy(dst + y * row_bytes, row(y), row_bytes);
+}
 
 unsigned char Image::get(int x, int y, int channel) const
 {
@@ -20,33 +97,47 @@ void Image::set(int x, int y, int channel, float value)
 
 Image Image::load(const std::string &path)
 {
+    CAR_TRACE_SCOPE("load");
     int w, h, c;
     unsigned char *raw = stbi_load(path.c_str(), &w, &h, &c, 0);
     if (!raw)
         throw std::runtime_error("Failed to load: " + path);
 
     Image img(w, h, c);
-    img.data.assign(raw, raw + w * h * c);
+    for (int y = 0; y < h; y++)
+        std::memcpy(img.row(y), raw + size_t(y) * w * c, size_t(w) * c);
     stbi_image_free(raw);
     return img;
 }
 
+bool Image::probe(const std::string &path, int &width, int &height, int &channels)
+{
+    return stbi_info(path.c_str(), &width, &height, &channels) != 0;
+}
+
 void Image::save_jpg(const std::string &path, int quality) const
 {
+    // stb_image_write has no stride parameter, so rows are packed first.
     if (nChannels == 3)
     {
-        stbi_write_jpg(path.c_str(), width, height, 3, data.data(), quality);
+        PixelBuffer rgb(size_t(width) * height * 3);
+        copy_packed(rgb.data());
+        write_jpg(path, width, height, rgb.data(), quality);
     }
     else if (nChannels == 4)
     {
-        std::vector<unsigned char> rgb(width * height * 3);
-        for (int i = 0, j = 0; i < width * height * 4; i += 4, j += 3)
+        PixelBuffer rgb(size_t(width) * height * 3);
+        for (int y = 0, j = 0; y < height; y++)
         {
-            rgb[j] = data[i];
-            rgb[j + 1] = data[i + 1];
-            rgb[j + 2] = data[i + 2];
+            const unsigned char *src = row(y);
+            for (int i = 0; i < width * 4; i += 4, j += 3)
+            {
+                rgb[j] = src[i];
+                rgb[j + 1] = src[i + 1];
+                rgb[j + 2] = src[i + 2];
+            }
         }
-        stbi_write_jpg(path.c_str(), width, height, 3, rgb.data(), quality);
+        write_jpg(path, width, height, rgb.data(), quality);
     }
     else
     {
@@ -54,7 +145,7 @@ void Image::save_jpg(const std::string &path, int quality) const
     }
 }
 
-int Image::index(int x, int y, int channel) const
+size_t Image::index(int x, int y, int channel) const
 {
-    return (y * width + x) * nChannels + channel;
+    return size_t(y) * stride + x * nChannels + channel;
 }
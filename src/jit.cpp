@@ -0,0 +1,340 @@
+#include <CAR-practica2/jit.hpp>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace
+{
+    // VEX fields: implied prefix (pp) and opcode map (m‑mmmm).
+    constexpr int kNone = 0, k66 = 1, kF3 = 2;
+    constexpr int k0F = 1, k0F38 = 2;
+
+    // SysV argument registers of RowFunction.
+    constexpr int kRdi = 7, kRsi = 6, kRdx = 2, kRcx = 1;
+    constexpr int kRowBase[3] = {kRdi, kRsi, kRdx};
+    constexpr int kOutBase = kRcx;
+
+    // ymm0–3 accumulate, ymm4–7 hold converted taps, ymm8–15 hold weights.
+    constexpr int kAcc = 0, kTmp = 4, kWeightRegs = 8, kMaxWeightRegs = 8;
+
+    /**
+     * @brief Minimal x86‑64 encoder for the instructions the row loop needs.
+     *
+     * Every vector instruction uses the three‑byte VEX prefix with L = 1
+     * (256 bits). Memory operands are either [base + rax + disp32], with rax
+     * the byte offset of the current block, or a RIP‑relative reference to a
+     * 32‑byte constant appended after the code by finish().
+     */
+    class Emitter
+    {
+    public:
+        std::vector<uint8_t> code;
+
+        void byte(uint8_t b) { code.push_back(b); }
+
+        void bytes(std::initializer_list<uint8_t> bs)
+        {
+            code.insert(code.end(), bs);
+        }
+
+        void u32(uint32_t v)
+        {
+            for (int i = 0; i < 4; i++)
+                byte(uint8_t(v >> (8 * i)));
+        }
+
+        /// op ymm(reg), ymm(vvvv), ymm(rm)
+        void vex_rr(int pp, int map, uint8_t opcode, int reg, int vvvv, int rm)
+        {
+            prefix(pp, map, reg, vvvv, rm >> 3);
+            byte(opcode);
+            byte(0xC0 | (reg & 7) << 3 | (rm & 7));
+        }
+
+        /// op ymm(reg), ymm(vvvv), [base + rax + disp]
+        void vex_mem(int pp, int map, uint8_t opcode, int reg, int vvvv, int base, int32_t disp)
+        {
+            prefix(pp, map, reg, vvvv, 0);
+            byte(opcode);
+            byte(0x80 | (reg & 7) << 3 | 4); // mod = 10: SIB + disp32
+            byte(0x00 | 0 << 3 | base);      // scale 1, index rax
+            u32(uint32_t(disp));
+        }
+
+        /// op ymm(reg), ymm(vvvv), [rip + constant]
+        void vex_const(int pp, int map, uint8_t opcode, int reg, int vvvv, int constant)
+        {
+            prefix(pp, map, reg, vvvv, 0);
+            byte(opcode);
+            byte((reg & 7) << 3 | 5); // mod = 00, rm = 101: RIP‑relative
+            fixups.push_back({code.size(), constant});
+            u32(0);
+        }
+
+        /// Adds a 32‑byte constant; returns its index for vex_const().
+        int constant(const void *data)
+        {
+            constants.emplace_back(32);
+            std::memcpy(constants.back().data(), data, 32);
+            return int(constants.size()) - 1;
+        }
+
+        /// Appends the constants (32‑byte aligned) and resolves their references.
+        void finish()
+        {
+            while (code.size() % 32)
+                byte(0xCC); // int3 padding, never executed
+            const size_t pool = code.size();
+            for (const auto &c : constants)
+                code.insert(code.end(), c.begin(), c.end());
+            for (const Fixup &f : fixups)
+            {
+                // Relative to the end of the instruction; disp32 is its last field.
+                const int32_t disp = int32_t(pool + 32 * size_t(f.constant) - (f.position + 4));
+                std::memcpy(&code[f.position], &disp, sizeof(disp));
+            }
+        }
+
+    private:
+        struct Fixup
+        {
+            size_t position;
+            int constant;
+        };
+        std::vector<Fixup> fixups;
+        std::vector<std::vector<uint8_t>> constants;
+
+        void prefix(int pp, int map, int reg, int vvvv, int b)
+        {
+            byte(0xC4);
+            byte((~reg >> 3 & 1) << 7 | 1 << 6 | (~b & 1) << 5 | map); // R̄ X̄ B̄ m‑mmmm
+            byte(0 << 7 | (~vvvv & 15) << 3 | 1 << 2 | pp);             // W v̄v̄v̄v̄ L pp
+        }
+    };
+
+    void vpmovzxbd(Emitter &e, int dst, int base, int32_t disp) { e.vex_mem(k66, k0F38, 0x31, dst, 0, base, disp); }
+    void vcvtdq2ps(Emitter &e, int dst, int src) { e.vex_rr(kNone, k0F, 0x5B, dst, 0, src); }
+    void vaddps(Emitter &e, int dst, int a, int b) { e.vex_rr(kNone, k0F, 0x58, dst, a, b); }
+    void vsubps(Emitter &e, int dst, int a, int b) { e.vex_rr(kNone, k0F, 0x5C, dst, a, b); }
+    void vmulps(Emitter &e, int dst, int a, int b) { e.vex_rr(kNone, k0F, 0x59, dst, a, b); }
+    void vmulps_const(Emitter &e, int dst, int a, int c) { e.vex_const(kNone, k0F, 0x59, dst, a, c); }
+    void vxorps(Emitter &e, int dst) { e.vex_rr(kNone, k0F, 0x57, dst, dst, dst); }
+    void vbroadcastss(Emitter &e, int dst, int c) { e.vex_const(k66, k0F38, 0x18, dst, 0, c); }
+    void vcvttps2dq(Emitter &e, int dst, int src) { e.vex_rr(kF3, k0F, 0x5B, dst, 0, src); }
+    void vpackssdw(Emitter &e, int dst, int a, int b) { e.vex_rr(k66, k0F, 0x6B, dst, a, b); }
+    void vpackuswb(Emitter &e, int dst, int a, int b) { e.vex_rr(k66, k0F, 0x67, dst, a, b); }
+    void vpermd(Emitter &e, int dst, int index, int src) { e.vex_rr(k66, k0F38, 0x36, dst, index, src); }
+    void vmovdqu_load(Emitter &e, int dst, int c) { e.vex_const(kF3, k0F, 0x6F, dst, 0, c); }
+    void vmovdqu_store(Emitter &e, int src, int base) { e.vex_mem(kF3, k0F, 0x7F, src, 0, base, 0); }
+
+    /// How a weight is applied: ±1 need no multiply, others use a register or a constant.
+    struct Weight
+    {
+        float value;
+        int reg = -1;      ///< ymm holding the broadcast weight, or −1.
+        int constant = -1; ///< 32‑byte broadcast constant.
+    };
+
+    std::vector<uint8_t> generate(const ConvolutionKernel &kernel, int nChannels)
+    {
+        Emitter e;
+
+        const int32_t order[8] = {0, 4, 1, 5, 2, 6, 3, 7};
+        const int order_constant = e.constant(order);
+
+        // One register (or constant) per distinct weight other than 0 and ±1.
+        std::vector<Weight> weights;
+        int tap_weight[9];
+        for (int t = 0; t < 9; t++)
+        {
+            const float w = kernel.data[t / 3][t % 3];
+            tap_weight[t] = -1;
+            if (w == 0 || w == 1 || w == -1)
+                continue;
+            size_t k = 0;
+            while (k < weights.size() && std::memcmp(&weights[k].value, &w, sizeof(w)) != 0)
+                k++;
+            if (k == weights.size())
+            {
+                float broadcast[8];
+                std::fill(broadcast, broadcast + 8, w);
+                Weight weight{w};
+                weight.constant = e.constant(broadcast);
+                if (int(k) < kMaxWeightRegs)
+                    weight.reg = kWeightRegs + int(k);
+                weights.push_back(weight);
+            }
+            tap_weight[t] = int(k);
+        }
+
+        // Prologue: hoist the broadcasts, rax = 0.
+        for (const Weight &w : weights)
+            if (w.reg >= 0)
+                vbroadcastss(e, w.reg, w.constant);
+        e.bytes({0x31, 0xC0}); // xor eax, eax
+
+        const size_t loop = e.code.size();
+        bool first = true;
+        for (int t = 0; t < 9; t++)
+        {
+            const float w = kernel.data[t / 3][t % 3];
+            if (w == 0)
+                continue; // p × 0 adds nothing to the float sum
+
+            for (int q = 0; q < 4; q++)
+            {
+                const int acc = kAcc + q, tmp = kTmp + q;
+                const int32_t disp = (t % 3 - 1) * nChannels + 8 * q;
+                // The first tap is assigned: 0 + p × w and p × w differ at most in the sign of zero.
+                const bool direct = first && w == 1;
+                vpmovzxbd(e, direct ? acc : tmp, kRowBase[t / 3], disp);
+                vcvtdq2ps(e, direct ? acc : tmp, direct ? acc : tmp);
+                if (direct)
+                    continue;
+
+                if (first && w == -1)
+                {
+                    vxorps(e, acc);
+                    vsubps(e, acc, acc, tmp);
+                    continue;
+                }
+                if (w == 1)
+                {
+                    vaddps(e, acc, acc, tmp);
+                    continue;
+                }
+                if (w == -1)
+                {
+                    vsubps(e, acc, acc, tmp);
+                    continue;
+                }
+
+                const Weight &weight = weights[tap_weight[t]];
+                const int product = first ? acc : tmp;
+                if (weight.reg >= 0)
+                    vmulps(e, product, tmp, weight.reg);
+                else
+                    vmulps_const(e, product, tmp, weight.constant);
+                if (!first)
+                    vaddps(e, acc, acc, tmp);
+            }
+            first = false;
+        }
+        if (first) // all taps zero
+            for (int q = 0; q < 4; q++)
+                vxorps(e, kAcc + q);
+
+        // Truncate, saturate to bytes, restore the lane order, store 32 bytes.
+        for (int q = 0; q < 4; q++)
+            vcvttps2dq(e, kAcc + q, kAcc + q);
+        vpackssdw(e, kAcc + 0, kAcc + 0, kAcc + 1);
+        vpackssdw(e, kAcc + 2, kAcc + 2, kAcc + 3);
+        vpackuswb(e, kAcc + 0, kAcc + 0, kAcc + 2);
+        vmovdqu_load(e, kTmp, order_constant);
+        vpermd(e, kAcc + 0, kTmp, kAcc + 0);
+        vmovdqu_store(e, kAcc + 0, kOutBase);
+
+        e.bytes({0x48, 0x83, 0xC0, KernelJit::kBlockBytes}); // add rax, 32
+        e.bytes({0x49, 0xFF, 0xC8});                         // dec r8
+        e.bytes({0x0F, 0x85});                               // jnz loop
+        e.u32(uint32_t(int32_t(loop - (e.code.size() + 4))));
+        e.bytes({0xC5, 0xF8, 0x77}); // vzeroupper
+        e.byte(0xC3);                // ret
+
+        e.finish();
+        return e.code;
+    }
+
+    struct JitKey
+    {
+        float weights[3][3];
+        int nChannels;
+
+        bool operator==(const JitKey &other) const
+        {
+            return std::memcmp(weights, other.weights, sizeof(weights)) == 0 && nChannels == other.nChannels;
+        }
+    };
+
+    /// FNV‑1a over the weight bits and the channel count.
+    struct JitKeyHash
+    {
+        size_t operator()(const JitKey &key) const
+        {
+            uint64_t h = 1469598103934665603ull;
+            auto mix = [&](const void *p, size_t n)
+            {
+                for (size_t i = 0; i < n; i++)
+                    h = (h ^ static_cast<const uint8_t *>(p)[i]) * 1099511628211ull;
+            };
+            mix(key.weights, sizeof(key.weights));
+            mix(&key.nChannels, sizeof(key.nChannels));
+            return size_t(h);
+        }
+    };
+
+    std::mutex cache_mutex;
+    // Leaked on purpose, like the buffer pools: the code stays mapped until exit.
+    auto *cache = new std::unordered_map<JitKey, KernelJit::RowFunction, JitKeyHash>();
+
+    /// Copies code into fresh pages and flips them from writable to executable.
+    KernelJit::RowFunction map_code(const std::vector<uint8_t> &code)
+    {
+        const size_t page = size_t(sysconf(_SC_PAGESIZE));
+        const size_t length = (code.size() + page - 1) / page * page;
+        void *p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return nullptr;
+        std::memcpy(p, code.data(), code.size());
+        if (mprotect(p, length, PROT_READ | PROT_EXEC) != 0)
+        {
+            munmap(p, length);
+            return nullptr;
+        }
+        return reinterpret_cast<KernelJit::RowFunction>(p);
+    }
+}
+
+bool KernelJit::supported()
+{
+#if defined(__x86_64__)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+std::vector<uint8_t> KernelJit::emit(const ConvolutionKernel &kernel, int nChannels)
+{
+    return generate(kernel, nChannels);
+}
+
+KernelJit::RowFunction KernelJit::compile(const ConvolutionKernel &kernel, int nChannels)
+{
+    if (!supported())
+        return nullptr;
+
+    JitKey key;
+    std::memcpy(key.weights, kernel.data, sizeof(key.weights));
+    key.nChannels = nChannels;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache->find(key);
+    if (it != cache->end())
+        return it->second;
+
+    RowFunction fn = map_code(generate(kernel, nChannels));
+    if (fn)
+        cache->emplace(key, fn);
+    return fn;
+}
+
+size_t KernelJit::cached()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return cache->size();
+}
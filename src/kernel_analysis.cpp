@@ -0,0 +1,216 @@
+#include <CAR-practica2/convolution.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+
+namespace
+{
+    /// Largest power‑of‑two denominator tried for fixed‑point weights.
+    constexpr int kMaxShift = 16;
+    /// Integer magnitudes below 2^24 are exact in float (24‑bit significand).
+    constexpr int64_t kExactLimit = int64_t(1) << 24;
+
+    /**
+     * @brief Finds the smallest shift with every weight × 2^shift an integer
+     *        and all partial sums of apply_linear() exact.
+     */
+    bool integer_weights(const float data[3][3], int weights[3][3], int &shift)
+    {
+        for (shift = 0; shift <= kMaxShift; shift++)
+        {
+            bool integral = true;
+            int64_t magnitude = 0;
+            for (int y = 0; y < 3 && integral; y++)
+                for (int x = 0; x < 3 && integral; x++)
+                {
+                    const double v = std::ldexp(double(data[y][x]), shift);
+                    integral = std::isfinite(v) && v == std::nearbyint(v) && std::fabs(v) < kExactLimit;
+                    if (integral)
+                    {
+                        weights[y][x] = int(v);
+                        magnitude += std::abs(weights[y][x]);
+                    }
+                }
+            if (integral)
+                // Every partial sum of pixel × n is bounded by 255 · Σ|n|.
+                return 255 * magnitude < kExactLimit;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Factors a rank‑one integer kernel as column ⊗ row with integer
+     *        factors. The row is the first non‑zero row divided by its gcd,
+     *        so every other row is an integer multiple of it.
+     */
+    bool integer_factors(const int weights[3][3], int column[3], int row[3])
+    {
+        int pivot = 0;
+        while (pivot < 3 && !weights[pivot][0] && !weights[pivot][1] && !weights[pivot][2])
+            pivot++;
+        if (pivot == 3)
+            return false;
+
+        int g = 0;
+        for (int x = 0; x < 3; x++)
+            g = std::gcd(g, std::abs(weights[pivot][x]));
+        for (int x = 0; x < 3; x++)
+            row[x] = weights[pivot][x] / g;
+
+        int px = 0;
+        while (!row[px])
+            px++;
+        for (int y = 0; y < 3; y++)
+        {
+            if (weights[y][px] % row[px])
+                return false;
+            column[y] = weights[y][px] / row[px];
+        }
+
+        for (int y = 0; y < 3; y++)
+            for (int x = 0; x < 3; x++)
+                if (column[y] * row[x] != weights[y][x])
+                    return false;
+        return true;
+    }
+
+    /// Rank‑one test for arbitrary float weights, relative to the largest weight.
+    bool rank_one(const float data[3][3])
+    {
+        int py = 0, px = 0;
+        for (int y = 0; y < 3; y++)
+            for (int x = 0; x < 3; x++)
+                if (std::fabs(data[y][x]) > std::fabs(data[py][px]))
+                    py = y, px = x;
+        const double pivot = data[py][px];
+        if (pivot == 0)
+            return false;
+
+        const double tolerance = 1e-6 * pivot * pivot;
+        for (int y = 0; y < 3; y++)
+            for (int x = 0; x < 3; x++)
+                if (std::fabs(double(data[y][x]) * pivot - double(data[y][px]) * data[py][x]) > tolerance)
+                    return false;
+        return true;
+    }
+
+    /// Adds and multiplies to combine taps with these weights (±1 needs no multiply).
+    int taps_cost(const int *weights, int n)
+    {
+        int nonzero = 0, multiplies = 0;
+        for (int i = 0; i < n; i++)
+        {
+            nonzero += weights[i] != 0;
+            multiplies += std::abs(weights[i]) > 1;
+        }
+        return std::max(nonzero - 1, 0) + multiplies;
+    }
+
+    int sparse_cost(const int weights[3][3])
+    {
+        // One multiply per distinct weight, after its taps are summed.
+        int distinct[9], n = 0, nonzero = 0;
+        for (int t = 0; t < 9; t++)
+        {
+            const int w = weights[t / 3][t % 3];
+            if (!w)
+                continue;
+            nonzero++;
+            if (std::find(distinct, distinct + n, w) == distinct + n)
+                distinct[n++] = w;
+        }
+        int multiplies = 0;
+        for (int i = 0; i < n; i++)
+            multiplies += std::abs(distinct[i]) > 1;
+        return std::max(nonzero - 1, 0) + multiplies;
+    }
+
+    int box_cost(const int weights[3][3])
+    {
+        // Row sums (2 adds, once per input row), column sum (2 adds), scale, centre.
+        const int a = weights[0][0], center = weights[1][1] - a;
+        return 4 + (std::abs(a) > 1) + (center ? 1 + (std::abs(center) > 1) : 0);
+    }
+}
+
+KernelAnalysis ConvolutionKernel::analyze() const
+{
+    KernelAnalysis a;
+
+    float distinct[9];
+    for (int t = 0; t < 9; t++)
+    {
+        const float w = data[t / 3][t % 3];
+        if (w == 0)
+            a.zero_taps++;
+        else if (std::find(distinct, distinct + a.distinct_weights, w) == distinct + a.distinct_weights)
+            distinct[a.distinct_weights++] = w;
+    }
+
+    a.symmetric_horizontal = a.symmetric_vertical = a.symmetric_point = true;
+    for (int y = 0; y < 3; y++)
+        for (int x = 0; x < 3; x++)
+        {
+            a.symmetric_horizontal &= data[y][x] == data[y][2 - x];
+            a.symmetric_vertical &= data[y][x] == data[2 - y][x];
+            a.symmetric_point &= data[y][x] == data[2 - y][2 - x];
+        }
+
+    a.box_plus_center = true;
+    for (int t = 0; t < 9; t++)
+        if (t != 4)
+            a.box_plus_center &= data[t / 3][t % 3] == data[0][0];
+
+    a.exact_integer = integer_weights(data, a.weights, a.shift);
+    if (!a.exact_integer)
+    {
+        a.shift = 0;
+        std::fill(&a.weights[0][0], &a.weights[0][0] + 9, 0);
+        a.separable = rank_one(data);
+        a.cost = 17;
+        return a;
+    }
+    a.separable = integer_factors(a.weights, a.column, a.row);
+
+    // Cheapest strategy; on a tie the more structured one wins, since it also
+    // reuses work between neighbouring rows.
+    a.strategy = KernelStrategy::Direct;
+    a.cost = 17; // 9 multiplies + 8 adds
+    auto consider = [&](KernelStrategy strategy, int cost)
+    {
+        if (cost <= a.cost)
+        {
+            a.strategy = strategy;
+            a.cost = cost;
+        }
+    };
+    consider(KernelStrategy::Sparse, sparse_cost(a.weights));
+    if (a.separable)
+        consider(KernelStrategy::Separable, taps_cost(a.row, 3) + taps_cost(a.column, 3));
+    if (a.box_plus_center)
+        consider(KernelStrategy::BoxPlusCenter, box_cost(a.weights));
+
+    if (a.strategy != KernelStrategy::Separable)
+    {
+        std::fill(a.column, a.column + 3, 0);
+        std::fill(a.row, a.row + 3, 0);
+    }
+    return a;
+}
+
+const char *KernelAnalysis::strategy_name(KernelStrategy strategy)
+{
+    switch (strategy)
+    {
+    case KernelStrategy::Sparse:
+        return "sparse";
+    case KernelStrategy::Separable:
+        return "separable";
+    case KernelStrategy::BoxPlusCenter:
+        return "box-plus-center";
+    default:
+        return "direct";
+    }
+}
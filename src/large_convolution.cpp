@@ -0,0 +1,373 @@
+#include <CAR-practica2/fft.hpp>
+#include <CAR-practica2/large_kernel.hpp>
+#include <CAR-practica2/synthetic.hpp>
+#include <CAR-practica2/trace.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    /// Largest FFT tile; a 1024² complex tile is already 8 MiB.
+    constexpr int kMaxTile = 1024;
+    constexpr int kMinTile = 16;
+
+    // Measured on the development machine (AVX‑512, one core) with calibrate().
+    LargeConvolver::CostModel model{0.093, 0.72};
+
+    /// Zeroes every output pixel the kernel does not fit around.
+    void clear_large_border(ImageView out, int rx, int ry)
+    {
+        const size_t row_bytes = size_t(out.width) * out.nChannels;
+        const int x_end = std::max(out.width - rx, rx);
+        for (int y = 0; y < out.height; y++)
+        {
+            if (y < ry || y >= out.height - ry || out.width <= 2 * rx)
+            {
+                std::memset(out.row(y), 0, row_bytes);
+                continue;
+            }
+            std::memset(out.row(y), 0, size_t(rx) * out.nChannels);
+            std::memset(out.row(y) + size_t(x_end) * out.nChannels, 0, size_t(out.width - x_end) * out.nChannels);
+        }
+    }
+
+    /// acc[n] += src[n] × w over [begin, end); always_inline so the wrappers widen it.
+    [[gnu::always_inline]] inline void accumulate_tap(float *acc, const float *src, float w, int begin, int end)
+    {
+        for (int n = begin; n < end; n++)
+            acc[n] += src[n] * w;
+    }
+
+    [[gnu::always_inline]] inline void direct_row(float *acc, const float *const *lines, const LargeKernel &kernel,
+                                                  int nChannels, int begin, int end)
+    {
+        const int rx = kernel.radius_x();
+        for (int j = 0; j < kernel.height; j++)
+            for (int i = 0; i < kernel.width; i++)
+            {
+                const float w = kernel.at(i, j);
+                if (w != 0) // p × 0 adds nothing to the float sum
+                    accumulate_tap(acc, lines[j] + (i - rx) * nChannels, w, begin, end);
+            }
+    }
+
+    __attribute__((target("avx2"))) void direct_row_avx2(float *acc, const float *const *lines,
+                                                         const LargeKernel &kernel, int nChannels, int begin, int end)
+    {
+        direct_row(acc, lines, kernel, nChannels, begin, end);
+    }
+
+    __attribute__((target("avx512f"))) void direct_row_avx512(float *acc, const float *const *lines,
+                                                              const LargeKernel &kernel, int nChannels,
+                                                              int begin, int end)
+    {
+        direct_row(acc, lines, kernel, nChannels, begin, end);
+    }
+
+    /// Work of one tile: forward plus inverse transform, T² points × log2(T²) radix‑2 stages each.
+    double tile_points(int tile)
+    {
+        return 2.0 * double(tile) * tile * 2 * std::log2(double(tile));
+    }
+
+    /// Transform work of apply_fft() on this image; each tile carries two blocks.
+    double fft_points(const LargeKernel &kernel, int width, int height, int nChannels)
+    {
+        const int tile = LargeConvolver::fft_tile_size(kernel, width, height);
+        const double blocks_x = std::ceil(double(width) / (tile - kernel.width + 1));
+        const double blocks_y = std::ceil(double(height) / (tile - kernel.height + 1));
+        const double pairs = std::ceil(blocks_x * blocks_y * nChannels / 2);
+        return pairs * tile_points(tile);
+    }
+
+    double direct_taps(const LargeKernel &kernel, int width, int height, int nChannels)
+    {
+        const double interior = double(std::max(width - 2 * kernel.radius_x(), 0)) *
+                                std::max(height - 2 * kernel.radius_y(), 0);
+        return interior * nChannels * kernel.taps();
+    }
+
+    template <typename F>
+    double seconds_of(F &&f)
+    {
+        using clock = std::chrono::steady_clock;
+        double best = 0;
+        for (int r = 0; r < 3; r++)
+        {
+            auto start = clock::now();
+            f();
+            std::chrono::duration<double> elapsed = clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        return best;
+    }
+}
+
+LargeKernel::LargeKernel(int width, int height) : width(width), height(height)
+{
+    if (width < 1 || height < 1 || width % 2 == 0 || height % 2 == 0)
+        throw std::runtime_error("Kernel sizes must be odd and positive");
+    weights.assign(size_t(width) * height, 0.0f);
+}
+
+LargeKernel::LargeKernel(const ConvolutionKernel &kernel) : LargeKernel(3, 3)
+{
+    for (int y = 0; y < 3; y++)
+        for (int x = 0; x < 3; x++)
+            at(x, y) = kernel.data[y][x];
+}
+
+int LargeKernel::taps() const
+{
+    return int(std::count_if(weights.begin(), weights.end(), [](float w) { return w != 0; }));
+}
+
+LargeKernel LargeKernel::gaussian(int radius, float sigma)
+{
+    LargeKernel k(2 * radius + 1, 2 * radius + 1);
+    double sum = 0;
+    for (int y = -radius; y <= radius; y++)
+        for (int x = -radius; x <= radius; x++)
+            sum += std::exp(-(x * x + y * y) / (2.0 * sigma * sigma));
+    for (int y = -radius; y <= radius; y++)
+        for (int x = -radius; x <= radius; x++)
+            k.at(x + radius, y + radius) = float(std::exp(-(x * x + y * y) / (2.0 * sigma * sigma)) / sum);
+    return k;
+}
+
+LargeKernel LargeKernel::unsharp(int radius, float sigma, float amount)
+{
+    LargeKernel k = gaussian(radius, sigma);
+    for (float &w : k.weights)
+        w *= -amount;
+    k.at(radius, radius) += 1 + amount;
+    return k;
+}
+
+void LargeConvolver::apply(ConstImageView img, ImageView out, const LargeKernel &kernel, LargeMethod method)
+{
+    if (method == LargeMethod::Auto)
+        method = choose(kernel, img.width, img.height, img.nChannels);
+    if (method == LargeMethod::Fft)
+        apply_fft(img, out, kernel);
+    else
+        apply_direct(img, out, kernel);
+}
+
+void LargeConvolver::apply_direct(ConstImageView img, ImageView out, const LargeKernel &kernel)
+{
+    Convolver::check_views(img, out);
+    CAR_TRACE_SCOPE("large_direct");
+    const int rx = kernel.radius_x(), ry = kernel.radius_y();
+    clear_large_border(out, rx, ry);
+    if (img.width <= 2 * rx || img.height <= 2 * ry)
+        return;
+
+    static const bool avx512 = __builtin_cpu_supports("avx512f");
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    // Each input row is converted to floats once and kept while output rows
+    // still read it: a ring of `height` lines, row y in slot y % height.
+    const int row_values = img.width * img.nChannels;
+    std::vector<float> ring(size_t(kernel.height) * row_values), acc(row_values);
+    auto convert = [&](int y)
+    {
+        const unsigned char *src = img.row(y);
+        float *line = ring.data() + size_t(y % kernel.height) * row_values;
+        for (int n = 0; n < row_values; n++)
+            line[n] = src[n];
+    };
+    for (int y = 0; y < kernel.height - 1; y++)
+        convert(y);
+
+    const int begin = rx * img.nChannels, end = (img.width - rx) * img.nChannels;
+    std::vector<const float *> lines(kernel.height);
+    for (int y = ry; y < img.height - ry; y++)
+    {
+        convert(y + ry);
+        for (int j = 0; j < kernel.height; j++)
+            lines[j] = ring.data() + size_t((y - ry + j) % kernel.height) * row_values;
+
+        std::fill(acc.begin() + begin, acc.begin() + end, 0.0f);
+        if (avx512)
+            direct_row_avx512(acc.data(), lines.data(), kernel, img.nChannels, begin, end);
+        else if (avx2)
+            direct_row_avx2(acc.data(), lines.data(), kernel, img.nChannels, begin, end);
+        else
+            direct_row(acc.data(), lines.data(), kernel, img.nChannels, begin, end);
+
+        unsigned char *o = out.row(y);
+        for (int n = begin; n < end; n++)
+            o[n] = std::clamp(acc[n], 0.0f, 255.0f);
+    }
+}
+
+void LargeConvolver::apply_fft(ConstImageView img, ImageView out, const LargeKernel &kernel)
+{
+    Convolver::check_views(img, out);
+    CAR_TRACE_SCOPE("large_fft");
+    const int rx = kernel.radius_x(), ry = kernel.radius_y();
+    clear_large_border(out, rx, ry);
+    if (img.width <= 2 * rx || img.height <= 2 * ry)
+        return;
+
+    const int tile = fft_tile_size(kernel, img.width, img.height);
+    const int block_w = tile - kernel.width + 1, block_h = tile - kernel.height + 1;
+    const Fft fft(tile);
+    const size_t points = size_t(tile) * tile;
+
+    // Correlation = convolution with the flipped kernel.
+    std::vector<Fft::Complex> spectrum(points);
+    for (int y = 0; y < kernel.height; y++)
+        for (int x = 0; x < kernel.width; x++)
+            spectrum[size_t(y) * tile + x] = kernel.at(kernel.width - 1 - x, kernel.height - 1 - y);
+    fft.transform_2d(spectrum.data(), false);
+
+    // Full convolution index p of a block at x0 lands on output x0 + p − rx.
+    const int nChannels = img.nChannels;
+    std::vector<float> acc(size_t(img.width) * img.height * nChannels, 0.0f);
+    struct Block
+    {
+        int channel, x0, y0;
+    };
+    std::vector<Block> blocks;
+    for (int c = 0; c < nChannels; c++)
+        for (int y0 = 0; y0 < img.height; y0 += block_h)
+            for (int x0 = 0; x0 < img.width; x0 += block_w)
+                blocks.push_back({c, x0, y0});
+
+    std::vector<Fft::Complex> data(points);
+    float *values = reinterpret_cast<float *>(data.data());
+    for (size_t b = 0; b < blocks.size(); b += 2)
+    {
+        // Block b in the real parts, block b + 1 (if any) in the imaginary parts.
+        const int pair = std::min<size_t>(2, blocks.size() - b);
+        std::fill(data.begin(), data.end(), Fft::Complex(0, 0));
+        for (int k = 0; k < pair; k++)
+        {
+            const Block &block = blocks[b + k];
+            const int w = std::min(block_w, img.width - block.x0), h = std::min(block_h, img.height - block.y0);
+            for (int y = 0; y < h; y++)
+            {
+                const unsigned char *src = img.pixel(block.x0, block.y0 + y) + block.channel;
+                float *dst = values + 2 * size_t(y) * tile + k;
+                for (int x = 0; x < w; x++)
+                    dst[2 * x] = src[x * nChannels];
+            }
+        }
+
+        fft.transform_2d(data.data(), false);
+        const float *s = reinterpret_cast<const float *>(spectrum.data());
+        for (size_t i = 0; i < 2 * points; i += 2)
+        {
+            const float re = values[i] * s[i] - values[i + 1] * s[i + 1];
+            const float im = values[i] * s[i + 1] + values[i + 1] * s[i];
+            values[i] = re;
+            values[i + 1] = im;
+        }
+        fft.transform_2d(data.data(), true);
+
+        for (int k = 0; k < pair; k++)
+        {
+            const Block &block = blocks[b + k];
+            // Only interior outputs are kept.
+            const int y_begin = std::max(block.y0 - ry, ry);
+            const int y_end = std::min(block.y0 + block_h + ry, img.height - ry);
+            const int x_begin = std::max(block.x0 - rx, rx);
+            const int x_end = std::min(block.x0 + block_w + rx, img.width - rx);
+            for (int y = y_begin; y < y_end; y++)
+            {
+                const float *src = values + 2 * (size_t(y - block.y0 + ry) * tile + (x_begin - block.x0 + rx)) + k;
+                float *dst = acc.data() + (size_t(y) * img.width + x_begin) * nChannels + block.channel;
+                for (int x = 0; x < x_end - x_begin; x++)
+                    dst[x * nChannels] += src[2 * x];
+            }
+        }
+    }
+
+    const int begin = rx * nChannels, end = (img.width - rx) * nChannels;
+    for (int y = ry; y < img.height - ry; y++)
+    {
+        const float *a = acc.data() + size_t(y) * img.width * nChannels;
+        unsigned char *o = out.row(y);
+        for (int n = begin; n < end; n++)
+            o[n] = std::clamp(a[n], 0.0f, 255.0f);
+    }
+}
+
+int LargeConvolver::fft_tile_size(const LargeKernel &kernel, int width, int height)
+{
+    const int k = std::max(kernel.width, kernel.height);
+    // A tile larger than the padded image only adds zeros.
+    const int cap = std::min(kMaxTile, Fft::next_power_of_two(std::max(width, height) + k - 1));
+    int best = 0;
+    double best_cost = 0;
+    for (int tile = std::max(kMinTile, Fft::next_power_of_two(k)); tile <= std::max(cap, kMinTile); tile *= 2)
+    {
+        const int block_w = tile - kernel.width + 1, block_h = tile - kernel.height + 1;
+        const double blocks = std::ceil(double(width) / block_w) * std::ceil(double(height) / block_h);
+        const double cost = blocks * tile_points(tile);
+        if (best == 0 || cost < best_cost)
+        {
+            best = tile;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+LargeMethod LargeConvolver::choose(const LargeKernel &kernel, int width, int height, int nChannels)
+{
+    if (width <= 2 * kernel.radius_x() || height <= 2 * kernel.radius_y() ||
+        std::max(kernel.width, kernel.height) > kMaxTile / 2)
+        return LargeMethod::Direct;
+    const double direct = model.direct_ns_per_tap * direct_taps(kernel, width, height, nChannels);
+    const double fft = model.fft_ns_per_point * fft_points(kernel, width, height, nChannels);
+    return fft < direct ? LargeMethod::Fft : LargeMethod::Direct;
+}
+
+int LargeConvolver::crossover(int width, int height, int nChannels)
+{
+    for (int size = 3; size <= std::min(width, height); size += 2)
+    {
+        LargeKernel dense(size, size);
+        std::fill(dense.weights.begin(), dense.weights.end(), 1.0f / (size * size));
+        if (choose(dense, width, height, nChannels) == LargeMethod::Fft)
+            return size;
+    }
+    return 0;
+}
+
+LargeConvolver::CostModel LargeConvolver::cost_model()
+{
+    return model;
+}
+
+LargeConvolver::CostModel LargeConvolver::calibrate()
+{
+    const Image input = SyntheticImage::generate(512, 512, 3, SyntheticPattern::Mixed, 1);
+    Image output(input.width, input.height, input.nChannels);
+    const LargeKernel kernel = LargeKernel::gaussian(7, 3.0f);
+
+    const double direct = seconds_of([&] { apply_direct(input.view(), output.view(), kernel); });
+    const double fft = seconds_of([&] { apply_fft(input.view(), output.view(), kernel); });
+    model.direct_ns_per_tap = direct * 1e9 / direct_taps(kernel, input.width, input.height, input.nChannels);
+    model.fft_ns_per_point = fft * 1e9 / fft_points(kernel, input.width, input.height, input.nChannels);
+    return model;
+}
+
+const char *LargeConvolver::method_name(LargeMethod method)
+{
+    switch (method)
+    {
+    case LargeMethod::Direct:
+        return "direct";
+    case LargeMethod::Fft:
+        return "fft";
+    default:
+        return "auto";
+    }
+}
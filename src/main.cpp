@@ -1,13 +1,372 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <iomanip>
 #include <filesystem>
 #include <CAR-practica2/image.hpp>
 #include <CAR-practica2/convolution.hpp>
+#include <CAR-practica2/synthetic.hpp>
+#include <CAR-practica2/trace.hpp>
+#include <CAR-practica2/memstats.hpp>
+#include <CAR-practica2/spec_report.hpp>
+#include <CAR-practica2/numa.hpp>
+#include <CAR-practica2/memory_budget.hpp>
+#include <CAR-practica2/static_kernel.hpp>
+#include <CAR-practica2/large_kernel.hpp>
 #include <chrono>
+#include <mutex>
 
 namespace fs = std::filesystem;
 
+struct Options
+{
+    Backend backend = Backend::Simd;
+    int max_images = 250;
+    std::string input_dir = "./LostCat-PS/LostCat-PS/pet/";
+    bool save_output = true;
+    bool in_place = false;
+    StoreMode stores = StoreMode::Auto;
+    std::string trace_path; // empty = tracing off
+    bool mem_stats = false;
+    BufferPool::HugePages huge_pages = BufferPool::HugePages::Off;
+    int threads = 1;
+    bool numa = false;
+    size_t mem_budget = 0; // bytes of images in flight; 0 = unlimited
+
+    // Backend throughput comparison (--bench)
+    bool bench = false;
+    int bench_runs = 10;
+    std::string bench_kernel = "edge";
+    bool bench_large = false;
+
+    // SPEC-style report (--spec FILE)
+    std::string spec_report;
+    std::string spec_reference = "other/spec-reference/reference.txt";
+    std::string spec_save_reference;
+    int spec_runs = SpecSuite::kReportableRuns;
+
+    // Synthetic input (no dataset needed)
+    bool synthetic = false;
+    int synthetic_width = 1024;
+    int synthetic_height = 768;
+    int synthetic_channels = 3;
+    uint64_t synthetic_seed = 1;
+    SyntheticPattern synthetic_pattern = SyntheticPattern::Mixed;
+};
+
+void print_usage(const char *prog)
+{
+    std::cout << "Usage: " << prog << " [--simd | --nosimd] [options]\n"
+              << "  --backend NAME        convolution backend (linear, simd, simd-gather, bytestream, blocked, fma,\n"
+              << "                        algebraic, static, jit, winograd)\n"
+              << "  --images N            process at most N images (default 250)\n"
+              << "  --input DIR           dataset directory\n"
+              << "  --no-save             do not write output JPEGs\n"
+              << "  --in-place            overwrite each input image instead of using a second frame\n"
+              << "  --stores MODE         output stores: auto | cached | streaming (default auto)\n"
+              << "  --trace FILE          write a Chrome trace-event timeline (needs -DCAR_TRACE=ON)\n"
+              << "  --threads N           worker threads (default 1)\n"
+              << "  --numa                pin workers per NUMA node and allocate frames node-locally\n"
+              << "  --mem-budget SIZE     cap decoded pixels in flight, e.g. 512M (default unlimited)\n"
+              << "  --huge-pages MODE     back large frames with huge pages: off | thp | explicit\n"
+              << "  --mem-stats           report allocations/bytes per image and peak RSS\n"
+              << "  --synthetic           generate images in memory instead of loading them\n"
+              << "  --size WxH            synthetic image size (default 1024x768)\n"
+              << "  --channels C          synthetic channel count, 1-4 (default 3)\n"
+              << "  --pattern NAME        noise | gradient | texture | mixed (default mixed)\n"
+              << "  --seed S              synthetic seed (default 1)\n"
+              << "  --bench               report MPix/s of every backend on a synthetic frame (--size, --channels)\n"
+              << "  --bench-runs N        timed runs per backend for --bench (default 10)\n"
+              << "  --bench-kernel NAME   edge | sharpen | blur | gaussian (default edge)\n"
+              << "  --bench-large         calibrate and time direct vs FFT convolution for growing kernels\n"
+              << "  --spec FILE           run the SPEC-style suite and write the report to FILE\n"
+              << "  --spec-runs N         runs per suite case (default 3)\n"
+              << "  --spec-reference F    reference times (default other/spec-reference/reference.txt)\n"
+              << "  --spec-save-reference F  also store this run's median times as a new reference\n";
+}
+
+Options parse_args(int argc, char **argv)
+{
+    Options opt;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+                throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "0" || arg == "--nosimd")
+            opt.backend = Backend::Linear;
+        else if (arg == "1" || arg == "--simd")
+            opt.backend = Backend::Simd;
+        else if (arg == "--backend")
+            opt.backend = Convolver::parse_backend(next());
+        else if (arg == "--images")
+            opt.max_images = std::stoi(next());
+        else if (arg == "--input")
+            opt.input_dir = next();
+        else if (arg == "--no-save")
+            opt.save_output = false;
+        else if (arg == "--in-place")
+            opt.in_place = true;
+        else if (arg == "--stores")
+            opt.stores = Convolver::parse_store_mode(next());
+        else if (arg == "--trace")
+            opt.trace_path = next();
+        else if (arg == "--threads")
+            opt.threads = std::stoi(next());
+        else if (arg == "--numa")
+            opt.numa = true;
+        else if (arg == "--mem-budget")
+            opt.mem_budget = MemoryBudget::parse_size(next());
+        else if (arg == "--huge-pages")
+            opt.huge_pages = BufferPool::parse_huge_pages(next());
+        else if (arg == "--mem-stats")
+            opt.mem_stats = true;
+        else if (arg == "--synthetic")
+            opt.synthetic = true;
+        else if (arg == "--size")
+        {
+            std::string size = next();
+            size_t x = size.find('x');
+            if (x == std::string::npos)
+                throw std::runtime_error("Expected WxH, got: " + size);
+            opt.synthetic_width = std::stoi(size.substr(0, x));
+            opt.synthetic_height = std::stoi(size.substr(x + 1));
+        }
+        else if (arg == "--channels")
+            opt.synthetic_channels = std::stoi(next());
+        else if (arg == "--pattern")
+            opt.synthetic_pattern = SyntheticImage::parse_pattern(next());
+        else if (arg == "--seed")
+            opt.synthetic_seed = std::stoull(next());
+        else if (arg == "--bench")
+            opt.bench = true;
+        else if (arg == "--bench-runs")
+            opt.bench_runs = std::stoi(next());
+        else if (arg == "--bench-kernel")
+            opt.bench_kernel = next();
+        else if (arg == "--bench-large")
+            opt.bench_large = true;
+        else if (arg == "--spec")
+            opt.spec_report = next();
+        else if (arg == "--spec-runs")
+            opt.spec_runs = std::stoi(next());
+        else if (arg == "--spec-reference")
+            opt.spec_reference = next();
+        else if (arg == "--spec-save-reference")
+            opt.spec_save_reference = next();
+        else if (arg == "--help" || arg == "-h")
+        {
+            print_usage(argv[0]);
+            std::exit(0);
+        }
+        else
+            throw std::runtime_error("Unknown argument: " + arg);
+    }
+
+    return opt;
+}
+
+Image generate_traced(const Options &opt, size_t i)
+{
+    CAR_TRACE_SCOPE("load");
+    return SyntheticImage::generate(opt.synthetic_width, opt.synthetic_height,
+                                    opt.synthetic_channels, opt.synthetic_pattern,
+                                    opt.synthetic_seed + i);
+}
+
+/**
+ * Bytes charged to the memory budget for one image: its frame, the output
+ * frame unless working in place, and one packed copy (the stb_image decode
+ * buffer while loading, the RGB buffer while saving).
+ */
+size_t image_charge(const Options &opt, const std::string &path)
+{
+    int w = opt.synthetic_width, h = opt.synthetic_height, c = opt.synthetic_channels;
+    if (!opt.synthetic && !Image::probe(path, w, h, c))
+        return 0; // loading will fail and report the error
+
+    const size_t frame = size_t(Image::stride_for(w, c)) * h;
+    return frame * (opt.in_place ? 1 : 2) + size_t(w) * h * c;
+}
+
+void print_memory_report(const AllocationCounters &allocs, size_t processed, long rss_before_kb,
+                         const std::vector<NumaNode> *numa_nodes, const MemoryBudget &budget)
+{
+    const double n = processed ? double(processed) : 1.0;
+
+    std::cout << "Memory:\n";
+    if (MemoryStats::tracking_compiled_in())
+    {
+        std::cout << "  allocations:      " << allocs.allocations
+                  << " (" << allocs.allocations / n << " per image)\n"
+                  << "  bytes allocated:  " << allocs.bytes_allocated
+                  << " (" << allocs.bytes_allocated / n << " per image)\n"
+                  << "  live at end:      "
+                  << int64_t(allocs.bytes_allocated - allocs.bytes_freed) << " bytes in "
+                  << int64_t(allocs.allocations - allocs.deallocations) << " blocks\n";
+    }
+    else
+    {
+        std::cout << "  allocation counts unavailable (configure with -DCAR_ALLOC_STATS=ON)\n";
+    }
+    BufferPool::Stats pool = BufferPool::global().stats();
+    std::cout << "  buffer pool:      " << pool.hits << " hits, " << pool.misses << " misses, "
+              << pool.cached_bytes << " bytes cached\n";
+    if (numa_nodes)
+    {
+        for (const NumaNode &node : *numa_nodes)
+        {
+            BufferPool::Stats s = BufferPool::for_node(node.id).stats();
+            std::cout << "  node " << node.id << " pool:      " << s.hits << " hits, " << s.misses
+                      << " misses, " << s.cached_bytes << " bytes cached\n";
+        }
+    }
+    if (budget.limit())
+        std::cout << "  memory budget:    " << budget.peak() << " of " << budget.limit()
+                  << " bytes at peak, " << budget.waits() << " images waited\n";
+    std::cout << "  RSS before batch: " << rss_before_kb << " KiB\n"
+              << "  RSS now:          " << MemoryStats::current_rss_kb() << " KiB\n"
+              << "  peak RSS:         " << MemoryStats::peak_rss_kb() << " KiB\n";
+}
+
+/**
+ * Times every backend on the same synthetic frame and prints throughput,
+ * relative to the original gather-based SIMD load stage.
+ */
+int run_backend_bench(const Options &opt)
+{
+    Image input = SyntheticImage::generate(opt.synthetic_width, opt.synthetic_height,
+                                           opt.synthetic_channels, opt.synthetic_pattern,
+                                           opt.synthetic_seed);
+    const double megapixels = double(input.width) * input.height / 1e6;
+    const std::pair<const char *, StaticKernel> named[] = {
+        {"edge", kEdgeKernel}, {"sharpen", kSharpenKernel}, {"blur", kBlurKernel}, {"gaussian", kGaussianKernel}};
+    const StaticKernel *selected = nullptr;
+    for (const auto &[name, k] : named)
+        if (opt.bench_kernel == name)
+            selected = &k;
+    if (!selected)
+        throw std::runtime_error("Unknown bench kernel: " + opt.bench_kernel);
+    const ConvolutionKernel kernel = selected->runtime();
+
+    Convolver convolver;
+    Image output;
+    std::vector<std::pair<Backend, double>> rates;
+    for (Backend backend : Convolver::backends())
+    {
+        convolver.do_convolve(input, output, kernel, backend); // warm up, size output
+        double best = 0;
+        for (int r = 0; r < std::max(opt.bench_runs, 1); r++)
+        {
+            double seconds = convolver.do_convolve(input, output, kernel, backend);
+            best = r == 0 ? seconds : std::min(best, seconds);
+        }
+        rates.push_back({backend, megapixels / best});
+    }
+
+    double baseline = 0;
+    for (const auto &[backend, rate] : rates)
+        if (backend == Backend::SimdGather)
+            baseline = rate;
+
+    std::cout << "Backend throughput, " << input.width << "x" << input.height << "x"
+              << input.nChannels << ", " << opt.bench_kernel << " kernel, best of " << std::max(opt.bench_runs, 1)
+              << " runs (algebraic: "
+              << KernelAnalysis::strategy_name(kernel.analyze().strategy) << "):\n";
+    for (const auto &[backend, rate] : rates)
+    {
+        std::cout << "  " << std::left << std::setw(14) << Convolver::backend_name(backend) << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(9) << rate << " MPix/s";
+        if (baseline > 0)
+            std::cout << std::setprecision(2) << std::setw(8) << rate / baseline << "x vs simd-gather";
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+/**
+ * Times direct and FFT convolution for Gaussians of growing radius on one
+ * synthetic frame, after calibrating the cost model apply() chooses with.
+ */
+int run_large_bench(const Options &opt)
+{
+    Image input = SyntheticImage::generate(opt.synthetic_width, opt.synthetic_height,
+                                           opt.synthetic_channels, opt.synthetic_pattern,
+                                           opt.synthetic_seed);
+    Image output(input.width, input.height, input.nChannels);
+    const int runs = std::clamp(opt.bench_runs, 1, 3);
+
+    const LargeConvolver::CostModel model = LargeConvolver::calibrate();
+    std::cout << "Large kernels, " << input.width << "x" << input.height << "x" << input.nChannels
+              << ", best of " << runs << " runs\n"
+              << "  cost model: " << std::setprecision(3) << model.direct_ns_per_tap << " ns/tap, "
+              << model.fft_ns_per_point << " ns/FFT point; FFT from "
+              << LargeConvolver::crossover(input.width, input.height, input.nChannels) << "x"
+              << LargeConvolver::crossover(input.width, input.height, input.nChannels) << " on\n";
+
+    using clock = std::chrono::steady_clock;
+    for (int radius : {1, 2, 3, 4, 5, 6, 8, 10, 15})
+    {
+        const LargeKernel kernel = LargeKernel::gaussian(radius, radius / 2.0f + 0.5f);
+        double seconds[2];
+        const LargeMethod methods[2] = {LargeMethod::Direct, LargeMethod::Fft};
+        for (int m = 0; m < 2; m++)
+            for (int r = 0; r < runs; r++)
+            {
+                auto start = clock::now();
+                LargeConvolver::apply(input.view(), output.view(), kernel, methods[m]);
+                std::chrono::duration<double> elapsed = clock::now() - start;
+                seconds[m] = r == 0 ? elapsed.count() : std::min(seconds[m], elapsed.count());
+            }
+        const LargeMethod chosen = LargeConvolver::choose(kernel, input.width, input.height, input.nChannels);
+        std::cout << "  " << std::setw(2) << kernel.width << "x" << std::left << std::setw(4) << kernel.height
+                  << std::right << std::fixed << std::setprecision(2) << " direct " << std::setw(9)
+                  << seconds[0] * 1e3 << " ms   fft " << std::setw(8) << seconds[1] * 1e3
+                  << " ms (tile " << LargeConvolver::fft_tile_size(kernel, input.width, input.height)
+                  << ")   auto: " << LargeConvolver::method_name(chosen) << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+    return 0;
+}
+
+int run_spec_suite(const Options &opt)
+{
+    std::cout << "Running SPEC-style suite (" << opt.spec_runs << " runs per case)\n";
+    std::vector<SpecCaseResult> results = SpecSuite::run(SpecSuite::default_cases(), opt.spec_runs);
+
+    std::string machine = "--";
+    try
+    {
+        auto reference = SpecSuite::load_reference(opt.spec_reference, machine);
+        for (auto &r : results)
+        {
+            auto it = reference.find(r.spec.name);
+            if (it != reference.end())
+                r.reference_seconds = it->second;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Warning: " << e.what() << " (ratios will be missing)\n";
+    }
+
+    if (!opt.spec_save_reference.empty())
+    {
+        SpecSuite::save_reference(opt.spec_save_reference, results);
+        std::cout << "Reference written to " << opt.spec_save_reference << "\n";
+    }
+
+    SpecSuite::write_report(opt.spec_report, results, machine);
+    std::cout << "Report written to " << opt.spec_report << "\n";
+    return 0;
+}
+
 std::vector<std::string> obtener_rutas_imagenes(const std::string &carpeta)
 {
 
@@ -33,62 +392,157 @@ int main(int argc, char **argv)
     using clock = std::chrono::high_resolution_clock;
     auto start = clock::now();
 
-    //>>>>>>>>>>>>>>>>>>>>
-    int MAX_N_IMAGES = 250;
-    //>>>>>>>>>>>>>>>>>>>>
+    Options opt;
+    try
+    {
+        opt = parse_args(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    BufferPool::global().set_huge_pages(opt.huge_pages);
+    NumaWorkerPool workers(opt.threads, opt.numa);
+    if (opt.numa)
+    {
+        for (const NumaNode &node : workers.nodes())
+            BufferPool::for_node(node.id).set_huge_pages(opt.huge_pages);
+    }
 
-    double elapsed_convolution_time = 0;
+    if (opt.bench || opt.bench_large)
+    {
+        try
+        {
+            return opt.bench_large ? run_large_bench(opt) : run_backend_bench(opt);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
 
-    bool use_simd = true; // default
+    if (!opt.spec_report.empty())
+    {
+        try
+        {
+            return run_spec_suite(opt);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
 
-    if (argc > 1)
+    if (!opt.trace_path.empty())
     {
-        std::string simd_flag = argv[1];
-        if (simd_flag == "0" || simd_flag == "--nosimd")
-            use_simd = false;
-        else if (simd_flag == "1" || simd_flag == "--simd")
-            use_simd = true;
+        if (!Tracer::compiled_in())
+            std::cerr << "Warning: tracing not compiled in (configure with -DCAR_TRACE=ON)\n";
+        Tracer::set_thread_name("main");
+        Tracer::start();
     }
 
-    fs::create_directories("output/");
+    double elapsed_convolution_time = 0;
 
-    std::vector<std::string> paths = obtener_rutas_imagenes("./LostCat-PS/LostCat-PS/pet/");
+    if (opt.save_output)
+        fs::create_directories("output/");
 
-    if (paths.size() > MAX_N_IMAGES)
+    std::vector<std::string> paths;
+    if (opt.synthetic)
+    {
+        for (int i = 0; i < opt.max_images; i++)
+            paths.push_back("synthetic_" + std::to_string(i) + ".jpg");
+    }
+    else
     {
-        paths.resize(MAX_N_IMAGES);
+        paths = obtener_rutas_imagenes(opt.input_dir);
     }
 
-    ConvolutionKernel edge_kernel = {
-        {-1, -1, -1},
-        {-1, 8, -1},
-        {-1, -1, -1}};
+    if (paths.size() > static_cast<size_t>(opt.max_images))
+    {
+        paths.resize(opt.max_images);
+    }
+
+    const ConvolutionKernel edge_kernel = kEdgeKernel.runtime();
+
+    AllocationCounters allocs_before = MemoryStats::snapshot();
+    long rss_before_kb = MemoryStats::current_rss_kb();
+    size_t processed = 0;
+    std::mutex report_mutex; // guards the two counters above and std::cerr
 
-    for (const auto &path : paths)
+    // One output frame per worker, reused for all its images: after the first
+    // image, convolution allocates nothing. Frames are allocated lazily by the
+    // worker, so with --numa they live on that worker's node.
+    Convolver convolver;
+    convolver.set_store_mode(opt.stores);
+    std::vector<Image> outputs(workers.workers());
+    MemoryBudget budget(opt.mem_budget);
+
+    auto process = [&](size_t i, int worker, int)
     {
+        const std::string &path = paths[i];
         try
         {
-            Image img = Image::load(path);
-            Convolver convolver;
-            ConvolutionResult res = convolver.do_convolve(img, edge_kernel, use_simd);
-            elapsed_convolution_time += res.elapsed_seconds;
+            BudgetCharge charge(budget, image_charge(opt, path));
+            Image img = opt.synthetic
+                            ? generate_traced(opt, i)
+                            : Image::load(path);
+            // With a budget the output is charged per image, so it must not
+            // outlive the charge in the worker's reusable frame.
+            Image budgeted_output;
+            Image &output = opt.mem_budget ? budgeted_output : outputs[worker];
+            double seconds;
+            if (opt.in_place)
+            {
+                auto conv_start = clock::now();
+                convolver.apply_in_place(img, edge_kernel, opt.backend);
+                std::chrono::duration<double> conv_elapsed = clock::now() - conv_start;
+                seconds = conv_elapsed.count();
+            }
+            else
+            {
+                seconds = convolver.do_convolve(img, output, edge_kernel, opt.backend);
+            }
+            const Image &result = opt.in_place ? img : output;
 
             std::string filename = path.substr(path.find_last_of("/\\") + 1);
-            res.output.save_jpg("output/" + filename);
+            if (opt.save_output)
+                result.save_jpg("output/" + filename);
 
+            std::lock_guard<std::mutex> lock(report_mutex);
+            elapsed_convolution_time += seconds;
+            processed++;
             // std::cout << "Processed: " << filename << "\n";
         }
         catch (const std::exception &e)
         {
+            std::lock_guard<std::mutex> lock(report_mutex);
             std::cerr << "Error: " << e.what() << "\n";
         }
-    }
+    };
+    workers.run(paths.size(), process);
+
+    AllocationCounters allocs = MemoryStats::snapshot() - allocs_before;
 
     auto end = clock::now();
     std::chrono::duration<double> elapsed = end - start;
 
+    if (!opt.trace_path.empty() && Tracer::compiled_in())
+    {
+        Tracer::stop();
+        Tracer::dump(opt.trace_path);
+        std::cout << "Trace written to " << opt.trace_path << "\n";
+    }
+
     std::cout << "Total execution time: " << elapsed.count() << " seconds\n";
     std::cout << "Total convolution time: " << elapsed_convolution_time << " seconds\n";
 
+    if (opt.mem_stats)
+        print_memory_report(allocs, processed, rss_before_kb, opt.numa ? &workers.nodes() : nullptr, budget);
+
     return 0;
 }
@@ -0,0 +1,96 @@
+#include <CAR-practica2/memory_budget.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+MemoryBudget::MemoryBudget(size_t limit_bytes) : limit_bytes(limit_bytes) {}
+
+bool MemoryBudget::admissible(size_t bytes, uint64_t ticket) const
+{
+    // An oversized request only needs everything else to have finished.
+    const bool fits = limit_bytes == 0 || used + bytes <= limit_bytes || used == 0;
+    if (!fits)
+        return false;
+    if (waiting.empty() || ticket == *waiting.begin())
+        return true;
+    return overtakes < kMaxOvertakes;
+}
+
+void MemoryBudget::acquire(size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint64_t ticket = next_ticket++;
+
+    if (!admissible(bytes, ticket))
+    {
+        wait_count++;
+        waiting.insert(ticket);
+        released.wait(lock, [&]
+                      { return admissible(bytes, ticket); });
+        waiting.erase(ticket);
+    }
+
+    // Passing the oldest waiter counts against its patience; serving it resets.
+    if (!waiting.empty() && ticket > *waiting.begin())
+        overtakes++;
+    else
+        overtakes = 0;
+
+    used += bytes;
+    peak_used = std::max(peak_used, used);
+
+    // A new oldest waiter may have been held back only by the overtake limit.
+    if (!waiting.empty() && overtakes == 0)
+        released.notify_all();
+}
+
+void MemoryBudget::release(size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        used -= std::min(bytes, used);
+    }
+    released.notify_all();
+}
+
+size_t MemoryBudget::in_use() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return used;
+}
+
+size_t MemoryBudget::peak() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return peak_used;
+}
+
+uint64_t MemoryBudget::waits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return wait_count;
+}
+
+size_t MemoryBudget::parse_size(const std::string &text)
+{
+    size_t pos = 0;
+    unsigned long long value = 0;
+    try
+    {
+        value = std::stoull(text, &pos);
+    }
+    catch (const std::exception &)
+    {
+        throw std::runtime_error("Invalid size: " + text);
+    }
+
+    std::string suffix = text.substr(pos);
+    if (suffix.empty() || suffix == "B")
+        return value;
+    if (suffix == "K" || suffix == "KiB")
+        return value << 10;
+    if (suffix == "M" || suffix == "MiB")
+        return value << 20;
+    if (suffix == "G" || suffix == "GiB")
+        return value << 30;
+    throw std::runtime_error("Invalid size: " + text);
+}
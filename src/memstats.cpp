@@ -0,0 +1,108 @@
+#include <CAR-practica2/memstats.hpp>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+
+#ifdef CAR_TRACK_ALLOCS
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::atomic<uint64_t> bytes_freed{0};
+
+    // Sizes are taken from malloc_usable_size on both sides so that unsized
+    // deletes balance exactly with the matching allocation.
+    void *counted_alloc(std::size_t size, std::size_t alignment)
+    {
+        if (size == 0)
+            size = 1;
+
+        void *p = alignment > alignof(std::max_align_t)
+                      ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                      : std::malloc(size);
+        if (!p)
+            return nullptr;
+
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+        return p;
+    }
+
+    void *counted_alloc_or_throw(std::size_t size, std::size_t alignment)
+    {
+        void *p = counted_alloc(size, alignment);
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+
+    void counted_free(void *p) noexcept
+    {
+        if (!p)
+            return;
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_freed.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+void *operator new(std::size_t size) { return counted_alloc_or_throw(size, 0); }
+void *operator new[](std::size_t size) { return counted_alloc_or_throw(size, 0); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size, 0); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size, 0); }
+void *operator new(std::size_t size, std::align_val_t a) { return counted_alloc_or_throw(size, std::size_t(a)); }
+void *operator new[](std::size_t size, std::align_val_t a) { return counted_alloc_or_throw(size, std::size_t(a)); }
+
+void operator delete(void *p) noexcept { counted_free(p); }
+void operator delete[](void *p) noexcept { counted_free(p); }
+void operator delete(void *p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void *p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+
+AllocationCounters MemoryStats::snapshot()
+{
+    return {allocations.load(std::memory_order_relaxed),
+            deallocations.load(std::memory_order_relaxed),
+            bytes_allocated.load(std::memory_order_relaxed),
+            bytes_freed.load(std::memory_order_relaxed)};
+}
+
+#else
+
+AllocationCounters MemoryStats::snapshot()
+{
+    return {};
+}
+
+#endif
+
+long MemoryStats::peak_rss_kb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return usage.ru_maxrss; // KiB on Linux
+}
+
+long MemoryStats::current_rss_kb()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind("VmRSS:", 0) == 0)
+            return std::stol(line.substr(6));
+    }
+    return -1;
+}
@@ -0,0 +1,198 @@
+#include <CAR-practica2/numa.hpp>
+#include <CAR-practica2/buffer_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+    // From <linux/mempolicy.h>, which is not always installed.
+    constexpr int kMpolPreferred = 1;
+    constexpr unsigned kMpolMfMove = 1u << 1;
+
+    /**
+     * @brief Parses a sysfs list such as "0-3,8,10-11".
+     */
+    std::vector<int> parse_list(const std::string &text)
+    {
+        std::vector<int> values;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            if (item.empty() || item == "\n")
+                continue;
+            size_t dash = item.find('-');
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            for (int v = first; v <= last; v++)
+                values.push_back(v);
+        }
+        return values;
+    }
+
+    std::string read_line(const std::string &path)
+    {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    }
+
+    std::vector<int> allowed_cpus()
+    {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                if (CPU_ISSET(cpu, &set))
+                    cpus.push_back(cpu);
+        }
+        if (cpus.empty())
+            cpus.push_back(0);
+        return cpus;
+    }
+}
+
+std::vector<NumaNode> NumaTopology::detect()
+{
+    std::vector<NumaNode> nodes;
+    const std::vector<int> allowed = allowed_cpus();
+
+    try
+    {
+        for (int id : parse_list(read_line("/sys/devices/system/node/online")))
+        {
+            NumaNode node{id, {}};
+            std::string path = "/sys/devices/system/node/node" + std::to_string(id) + "/cpulist";
+            for (int cpu : parse_list(read_line(path)))
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+                    node.cpus.push_back(cpu);
+            // Memory‑only nodes (and nodes outside our cpuset) get no workers.
+            if (!node.cpus.empty())
+                nodes.push_back(std::move(node));
+        }
+    }
+    catch (const std::exception &)
+    {
+        nodes.clear();
+    }
+
+    if (nodes.empty())
+        nodes.push_back({0, allowed});
+    return nodes;
+}
+
+bool NumaTopology::pin_current_thread(const NumaNode &node)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : node.cpus)
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool NumaTopology::bind_memory(void *p, size_t bytes, int node)
+{
+    if (node < 0 || node >= 64)
+        return false;
+
+    // mbind works on whole pages; only bind the pages that lie entirely inside.
+    const uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE));
+    uintptr_t start = (reinterpret_cast<uintptr_t>(p) + page - 1) & ~(page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(p) + bytes) & ~(page - 1);
+    if (end <= start)
+        return false;
+
+    unsigned long mask = 1ul << node;
+    // Preferred rather than bind: fall back to other nodes instead of OOM.
+    long rc = syscall(SYS_mbind, start, end - start, kMpolPreferred, &mask,
+                      sizeof(mask) * 8, kMpolMfMove);
+    return rc == 0;
+}
+
+NumaWorkerPool::NumaWorkerPool(int total_workers, bool numa_aware)
+    : numa_aware(numa_aware)
+{
+    total_workers = std::max(total_workers, 1);
+    if (numa_aware)
+    {
+        groups = NumaTopology::detect();
+        total_workers = std::max(total_workers, int(groups.size()));
+    }
+    else
+    {
+        groups.push_back({-1, {}});
+    }
+
+    // Spread the workers evenly, the first groups taking the remainder.
+    for (size_t g = 0; g < groups.size(); g++)
+        workers_per_group.push_back(total_workers / int(groups.size()) +
+                                    (int(g) < total_workers % int(groups.size()) ? 1 : 0));
+    this->total_workers = total_workers;
+}
+
+void NumaWorkerPool::run(size_t n_jobs, const Job &fn)
+{
+    const size_t n_groups = groups.size();
+    // Job j belongs to group j % n_groups; next[g] counts that group's share.
+    std::vector<std::atomic<size_t>> next(n_groups);
+    for (auto &n : next)
+        n.store(0);
+
+    auto worker_loop = [&](size_t group, int worker)
+    {
+        const NumaNode &node = groups[group];
+        if (numa_aware)
+        {
+            NumaTopology::pin_current_thread(node);
+            BufferPool::set_local(&BufferPool::for_node(node.id));
+        }
+
+        for (;;)
+        {
+            size_t job = next[group].fetch_add(1) * n_groups + group;
+            if (job >= n_jobs)
+                break;
+            fn(job, worker, node.id);
+        }
+
+        BufferPool::set_local(nullptr);
+    };
+
+    std::vector<std::thread> threads;
+    int worker = 0;
+    for (size_t g = 0; g < n_groups; g++)
+        for (int i = 0; i < workers_per_group[g]; i++, worker++)
+        {
+            // The first worker is the calling thread itself.
+            if (worker > 0)
+                threads.emplace_back(worker_loop, g, worker);
+        }
+
+    if (numa_aware)
+    {
+        // Restore the caller's affinity after it has worked for group 0.
+        cpu_set_t saved;
+        bool have_saved = sched_getaffinity(0, sizeof(saved), &saved) == 0;
+        worker_loop(0, 0);
+        if (have_saved)
+            sched_setaffinity(0, sizeof(saved), &saved);
+    }
+    else
+    {
+        worker_loop(0, 0);
+    }
+
+    for (auto &t : threads)
+        t.join();
+}
@@ -0,0 +1,322 @@
+#include <CAR-practica2/spec_report.hpp>
+#include <CAR-practica2/static_kernel.hpp>
+#include <CAR-practica2/synthetic.hpp>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace
+{
+    struct NamedKernel
+    {
+        const char *name;
+        ConvolutionKernel kernel;
+    };
+
+    const std::vector<NamedKernel> &suite_kernels()
+    {
+        static const std::vector<NamedKernel> kernels = {
+            {"edge", kEdgeKernel.runtime()},
+            {"sharpen", kSharpenKernel.runtime()},
+            {"blur", kBlurKernel.runtime()},
+        };
+        return kernels;
+    }
+
+    const ConvolutionKernel &kernel_by_name(const std::string &name)
+    {
+        for (const auto &k : suite_kernels())
+            if (name == k.name)
+                return k.kernel;
+        throw std::runtime_error("Unknown suite kernel: " + name);
+    }
+
+    struct SuiteSize
+    {
+        const char *name;
+        int width, height, repetitions;
+    };
+
+    // Repetitions keep every case at roughly 4–8 megapixels per run.
+    const SuiteSize suite_sizes[] = {
+        {"vga", 640, 480, 12},
+        {"hd", 1920, 1080, 2},
+        {"uhd", 3840, 2160, 1},
+    };
+
+    std::string cpu_model()
+    {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line))
+        {
+            if (line.rfind("model name", 0) == 0)
+                return line.substr(line.find(':') + 2);
+        }
+        return "--";
+    }
+
+    std::string host_name()
+    {
+        char name[256] = {};
+        if (gethostname(name, sizeof(name) - 1) != 0)
+            return "--";
+        return name;
+    }
+
+    std::string build_description()
+    {
+        std::ostringstream oss;
+        oss << "g++ " << __VERSION__;
+#ifdef __OPTIMIZE__
+        oss << ", optimized";
+#else
+        oss << ", -O0";
+#endif
+#ifdef __AVX2__
+        oss << ", AVX2";
+#endif
+        return oss.str();
+    }
+
+    bool built_with_sanitizers()
+    {
+#if defined(__SANITIZE_ADDRESS__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    double ratio(double reference, double run)
+    {
+        return reference > 0 && run > 0 ? 100.0 * reference / run : 0.0;
+    }
+
+    double geometric_mean(const std::vector<double> &values)
+    {
+        if (values.empty())
+            return 0.0;
+        double log_sum = 0.0;
+        for (double v : values)
+            log_sum += std::log(v);
+        return std::exp(log_sum / values.size());
+    }
+
+    std::string fixed(double value, int precision)
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(precision) << value;
+        return oss.str();
+    }
+}
+
+double SpecCaseResult::median() const
+{
+    std::vector<double> sorted = run_seconds;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted.empty() ? 0.0 : sorted[(sorted.size() - 1) / 2];
+}
+
+double SpecCaseResult::best() const
+{
+    return run_seconds.empty() ? 0.0 : *std::min_element(run_seconds.begin(), run_seconds.end());
+}
+
+std::vector<SpecCase> SpecSuite::default_cases()
+{
+    std::vector<SpecCase> cases;
+    for (Backend backend : Convolver::backends())
+        for (const auto &k : suite_kernels())
+            for (const auto &size : suite_sizes)
+            {
+                std::string name = std::string(Convolver::backend_name(backend)) + "." + k.name + "." + size.name;
+                cases.push_back({name, backend, k.name, size.width, size.height, size.repetitions});
+            }
+    return cases;
+}
+
+std::vector<SpecCaseResult> SpecSuite::run(const std::vector<SpecCase> &cases, int runs, bool log)
+{
+    std::vector<SpecCaseResult> results;
+    Convolver convolver;
+
+    Image input;
+    for (const SpecCase &c : cases)
+    {
+        if (input.width != c.width || input.height != c.height)
+            input = SyntheticImage::generate(c.width, c.height, 3, SyntheticPattern::Texture, 2026);
+
+        const ConvolutionKernel &kernel = kernel_by_name(c.kernel_name);
+        SpecCaseResult result{c, {}, 0};
+
+        for (int r = 0; r < std::max(runs, 1); r++)
+        {
+            double seconds = 0;
+            for (int i = 0; i < c.repetitions; i++)
+                seconds += convolver.do_convolve(input, kernel, c.backend).elapsed_seconds;
+            result.run_seconds.push_back(seconds);
+        }
+
+        if (log)
+            std::cout << "  " << std::left << std::setw(24) << c.name << std::right
+                      << fixed(result.median(), 4) << " s\n";
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+std::map<std::string, double> SpecSuite::load_reference(const std::string &path,
+                                                       std::string &machine_name)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("Failed to open reference: " + path);
+
+    std::map<std::string, double> reference;
+    std::string line;
+    machine_name = "--";
+    while (std::getline(in, line))
+    {
+        if (line.rfind("# machine:", 0) == 0)
+        {
+            machine_name = line.substr(line.find(':') + 1);
+            machine_name.erase(0, machine_name.find_first_not_of(' '));
+            continue;
+        }
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        std::string name;
+        double seconds;
+        if (fields >> name >> seconds)
+            reference[name] = seconds;
+    }
+    return reference;
+}
+
+void SpecSuite::save_reference(const std::string &path, const std::vector<SpecCaseResult> &results)
+{
+    std::ofstream out(path);
+    if (!out)
+        throw std::runtime_error("Failed to write reference: " + path);
+
+    out << "# machine: " << cpu_model() << " (" << host_name() << ")\n"
+        << "# build: " << build_description() << "\n"
+        << "# <case> <median seconds>\n";
+    for (const auto &r : results)
+        out << r.spec.name << " " << fixed(r.median(), 6) << "\n";
+}
+
+void SpecSuite::write_report(const std::string &path,
+                             const std::vector<SpecCaseResult> &results,
+                             const std::string &machine_name)
+{
+    std::ofstream out(path);
+    if (!out)
+        throw std::runtime_error("Failed to write report: " + path);
+
+    // Reasons the run would not be "reportable", as in SPEC's banner.
+    std::vector<std::string> invalid;
+    if (built_with_sanitizers())
+        invalid.push_back("binary built with sanitizers; use a bench-* target");
+    for (const auto &r : results)
+    {
+        if (r.reference_seconds <= 0)
+            invalid.push_back(r.spec.name + " has no reference time!");
+        if (r.run_seconds.size() < size_t(kReportableRuns))
+            invalid.push_back(r.spec.name + " base did not have enough runs!");
+    }
+
+    const std::string rule(78, '#');
+    if (!invalid.empty())
+    {
+        out << rule << "\n"
+            << "#   INVALID RUN INVALID RUN INVALID RUN INVALID RUN INVALID RUN INVALID RUN  #\n";
+        for (const auto &reason : invalid)
+            out << "# " << std::left << std::setw(74) << reason.substr(0, 74) << std::right << " #\n";
+        out << rule << "\n";
+    }
+
+    std::time_t now = std::time(nullptr);
+    char date[64];
+    std::strftime(date, sizeof(date), "%a %b %d %H:%M:%S %Y", std::localtime(&now));
+
+    out << "                       SPEC-style Convolution Suite Summary\n"
+        << "                           " << date << "\n\n"
+        << "Host: " << host_name() << "\n"
+        << "CPU: " << cpu_model() << "\n"
+        << "Build: " << build_description() << "\n"
+        << "Reference machine: " << machine_name << "\n\n";
+
+    auto header = [&]()
+    {
+        out << "                                 Base      Base      Base      Peak      Peak      Peak\n"
+            << "   Benchmarks                  Ref Time  Run Time   Ratio    Ref Time  Run Time   Ratio\n"
+            << "   --------------------------  --------  --------  --------  --------  --------  --------\n";
+    };
+
+    auto row = [&](const SpecCaseResult &r, double base, double peak, bool selected)
+    {
+        out << "   " << std::left << std::setw(26) << r.spec.name << std::right;
+        if (r.reference_seconds > 0)
+            out << std::setw(10) << fixed(r.reference_seconds, 3);
+        else
+            out << std::setw(10) << "--";
+        out << std::setw(10) << fixed(base, 3)
+            << std::setw(10) << (r.reference_seconds > 0 ? fixed(ratio(r.reference_seconds, base), 1) : "--")
+            << (selected ? "*" : " ");
+        if (peak > 0)
+        {
+            out << std::setw(9) << (r.reference_seconds > 0 ? fixed(r.reference_seconds, 3) : "--")
+                << std::setw(10) << fixed(peak, 3)
+                << std::setw(10) << (r.reference_seconds > 0 ? fixed(ratio(r.reference_seconds, peak), 1) : "--");
+        }
+        out << "\n";
+    };
+
+    // Every run; the median (the one used for base) is marked with '*'.
+    header();
+    for (const auto &r : results)
+    {
+        double median = r.median();
+        bool marked = false;
+        for (double t : r.run_seconds)
+        {
+            bool selected = !marked && t == median;
+            marked = marked || selected;
+            row(r, t, 0, selected);
+        }
+    }
+
+    // Selected results and the overall scores.
+    std::vector<double> base_ratios, peak_ratios;
+    out << "   " << std::string(86, '=') << "\n";
+    for (const auto &r : results)
+    {
+        row(r, r.median(), r.best(), true);
+        if (r.reference_seconds > 0)
+        {
+            base_ratios.push_back(ratio(r.reference_seconds, r.median()));
+            peak_ratios.push_back(ratio(r.reference_seconds, r.best()));
+        }
+    }
+
+    auto score = [&](const std::vector<double> &ratios)
+    {
+        return ratios.empty() ? std::string("--") : fixed(geometric_mean(ratios), 1);
+    };
+    out << "   Est. SPECconv_base" << std::setw(38) << score(base_ratios) << "\n"
+        << "   Est. SPECconv_peak" << std::setw(68) << score(peak_ratios) << "\n\n"
+        << "Base uses the median of " << kReportableRuns << " runs, peak the best run.\n"
+        << "Ratio = 100 x reference time / run time; scores are geometric means.\n";
+
+    if (!out)
+        throw std::runtime_error("Failed to write report: " + path);
+}
@@ -0,0 +1,165 @@
+#include <CAR-practica2/synthetic.hpp>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    /// splitmix64: tiny, fast and identical on every platform.
+    uint64_t mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    /// Uniform float in [0, 1) from a hashed lattice coordinate.
+    float lattice(uint64_t seed, int x, int y, int octave)
+    {
+        uint64_t h = mix(seed ^ mix((uint64_t(uint32_t(x)) << 32) | uint32_t(y)) ^ (uint64_t(octave) << 56));
+        return float(h >> 40) / float(1ull << 24);
+    }
+
+    float smooth(float t)
+    {
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    /// Bilinearly interpolated value noise with a cell size of `cell` pixels.
+    float value_noise(uint64_t seed, int x, int y, int cell, int octave)
+    {
+        int cx = x / cell, cy = y / cell;
+        float fx = smooth(float(x % cell) / cell);
+        float fy = smooth(float(y % cell) / cell);
+
+        float v00 = lattice(seed, cx, cy, octave);
+        float v10 = lattice(seed, cx + 1, cy, octave);
+        float v01 = lattice(seed, cx, cy + 1, octave);
+        float v11 = lattice(seed, cx + 1, cy + 1, octave);
+
+        float top = v00 + (v10 - v00) * fx;
+        float bottom = v01 + (v11 - v01) * fx;
+        return top + (bottom - top) * fy;
+    }
+
+    void fill_noise(Image &img, uint64_t seed)
+    {
+        uint64_t state = mix(seed);
+        for (int y = 0; y < img.height; y++)
+            for (int x = 0; x < img.width; x++)
+                for (int c = 0; c < img.nChannels; c++)
+                {
+                    state = mix(state);
+                    img.set(x, y, c, float(state & 0xFF));
+                }
+    }
+
+    void fill_gradient(Image &img, uint64_t seed)
+    {
+        uint64_t h = mix(seed);
+        // Integer direction instead of cos/sin of an angle: libm results vary
+        // between toolchains, a division of exact integers does not.
+        int64_t dx = int64_t(h & 0xFF) - 128, dy = int64_t((h >> 8) & 0xFF) - 128;
+        if (dx == 0 && dy == 0)
+            dx = 1;
+        float span = float(std::abs(dx) * img.width + std::abs(dy) * img.height + 1);
+
+        for (int y = 0; y < img.height; y++)
+            for (int x = 0; x < img.width; x++)
+            {
+                float t = float(x * dx + y * dy) / span;
+                for (int c = 0; c < img.nChannels; c++)
+                {
+                    float phase = float((h >> (16 + 8 * c)) & 0xFF) / 256.0f;
+                    float v = t + phase;
+                    v -= std::floor(v);
+                    // Triangle wave so the gradient has no hard seam.
+                    img.set(x, y, c, 255.0f * (v < 0.5f ? 2.0f * v : 2.0f - 2.0f * v));
+                }
+            }
+    }
+
+    void fill_texture(Image &img, uint64_t seed)
+    {
+        // Large smooth regions (fur, background) plus finer detail and a few
+        // hard edges: roughly the statistics of the pet photos in the dataset.
+        const int base_cell = std::max(8, std::min(img.width, img.height) / 4);
+
+        for (int y = 0; y < img.height; y++)
+            for (int x = 0; x < img.width; x++)
+            {
+                float lum = 0.0f, amp = 0.5f;
+                int cell = base_cell;
+                for (int octave = 0; octave < 5 && cell >= 2; octave++)
+                {
+                    lum += amp * value_noise(seed, x, y, cell, octave);
+                    amp *= 0.5f;
+                    cell /= 2;
+                }
+
+                // Object boundary: threshold on a low‑frequency field.
+                float region = value_noise(seed ^ 0x5EEDull, x, y, base_cell * 2, 7);
+                float edge = region > 0.5f ? 0.25f : -0.15f;
+
+                for (int c = 0; c < img.nChannels; c++)
+                {
+                    float tint = 0.8f + 0.4f * lattice(seed, c, 0, 9);
+                    float grain = lattice(seed, x, y, 16 + c) - 0.5f;
+                    img.set(x, y, c, 255.0f * ((lum + edge) * tint) + 12.0f * grain);
+                }
+            }
+    }
+}
+
+Image SyntheticImage::generate(int width, int height, int channels,
+                               SyntheticPattern pattern, uint64_t seed)
+{
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        throw std::runtime_error("Invalid synthetic image dimensions");
+
+    if (pattern == SyntheticPattern::Mixed)
+        pattern = static_cast<SyntheticPattern>(seed % 3);
+
+    Image img(width, height, channels);
+    switch (pattern)
+    {
+    case SyntheticPattern::Noise:
+        fill_noise(img, seed);
+        break;
+    case SyntheticPattern::Gradient:
+        fill_gradient(img, seed);
+        break;
+    default:
+        fill_texture(img, seed);
+        break;
+    }
+    return img;
+}
+
+SyntheticPattern SyntheticImage::parse_pattern(const std::string &name)
+{
+    if (name == "noise")
+        return SyntheticPattern::Noise;
+    if (name == "gradient")
+        return SyntheticPattern::Gradient;
+    if (name == "texture")
+        return SyntheticPattern::Texture;
+    if (name == "mixed")
+        return SyntheticPattern::Mixed;
+    throw std::runtime_error("Unknown synthetic pattern: " + name);
+}
+
+const char *SyntheticImage::pattern_name(SyntheticPattern pattern)
+{
+    switch (pattern)
+    {
+    case SyntheticPattern::Noise:
+        return "noise";
+    case SyntheticPattern::Gradient:
+        return "gradient";
+    case SyntheticPattern::Texture:
+        return "texture";
+    default:
+        return "mixed";
+    }
+}
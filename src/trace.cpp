@@ -0,0 +1,157 @@
+#include <CAR-practica2/trace.hpp>
+#include <stdexcept>
+
+#ifdef CAR_ENABLE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+namespace
+{
+    struct Event
+    {
+        const char *name;
+        int64_t arg;
+        int64_t timestamp_ns;
+        char phase;
+    };
+
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Event[]> events{new Event[Tracer::kEventsPerThread]};
+        std::atomic<size_t> count{0};
+        std::atomic<size_t> dropped{0};
+        std::atomic<const char *> name{nullptr};
+        uint32_t tid = 0;
+        ThreadBuffer *next = nullptr;
+    };
+
+    std::atomic<bool> enabled{false};
+    std::atomic<ThreadBuffer *> buffers{nullptr};
+    std::atomic<uint32_t> next_tid{1};
+
+    const auto epoch = std::chrono::steady_clock::now();
+
+    ThreadBuffer &local_buffer()
+    {
+        // Intentionally leaked: the dump may run after the owning thread exited.
+        thread_local ThreadBuffer *buffer = []
+        {
+            auto *b = new ThreadBuffer;
+            b->tid = next_tid.fetch_add(1, std::memory_order_relaxed);
+            b->next = buffers.load(std::memory_order_relaxed);
+            while (!buffers.compare_exchange_weak(b->next, b,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed))
+                ;
+            return b;
+        }();
+        return *buffer;
+    }
+
+    void write_escaped(std::ofstream &out, const char *s)
+    {
+        for (; *s; s++)
+        {
+            if (*s == '"' || *s == '\\')
+                out << '\\';
+            out << *s;
+        }
+    }
+}
+
+void Tracer::start()
+{
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop()
+{
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::set_thread_name(const char *name)
+{
+    local_buffer().name.store(name, std::memory_order_relaxed);
+}
+
+void Tracer::record(const char *name, char phase, int64_t arg)
+{
+    if (!enabled.load(std::memory_order_relaxed))
+        return;
+
+    ThreadBuffer &b = local_buffer();
+    size_t n = b.count.load(std::memory_order_relaxed);
+    if (n >= kEventsPerThread)
+    {
+        b.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now() - epoch;
+    b.events[n] = Event{name, arg,
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(),
+                        phase};
+    b.count.store(n + 1, std::memory_order_release);
+}
+
+void Tracer::dump(const std::string &path)
+{
+    std::ofstream out(path);
+    if (!out)
+        throw std::runtime_error("Failed to open trace file: " + path);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t dropped = 0;
+
+    for (ThreadBuffer *b = buffers.load(std::memory_order_acquire); b; b = b->next)
+    {
+        const char *thread_name = b->name.load(std::memory_order_relaxed);
+        if (thread_name)
+        {
+            out << (first ? "" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+                << ",\"args\":{\"name\":\"";
+            write_escaped(out, thread_name);
+            out << "\"}}";
+            first = false;
+        }
+
+        size_t n = b->count.load(std::memory_order_acquire);
+        dropped += b->dropped.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; i++)
+        {
+            const Event &e = b->events[i];
+            out << (first ? "" : ",\n") << "{\"name\":\"";
+            write_escaped(out, e.name);
+            out << "\",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << b->tid
+                << ",\"ts\":" << e.timestamp_ns / 1000 << '.'
+                << std::to_string(1000 + e.timestamp_ns % 1000).substr(1);
+            if (e.arg >= 0)
+                out << ",\"args\":{\"value\":" << e.arg << '}';
+            out << '}';
+            first = false;
+        }
+    }
+
+    out << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+    if (!out)
+        throw std::runtime_error("Failed to write trace file: " + path);
+}
+
+#else
+
+void Tracer::start() {}
+void Tracer::stop() {}
+void Tracer::set_thread_name(const char *) {}
+void Tracer::record(const char *, char, int64_t) {}
+
+void Tracer::dump(const std::string &)
+{
+    throw std::runtime_error("Tracing support not compiled in (configure with -DCAR_TRACE=ON)");
+}
+
+#endif
@@ -2,12 +2,24 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <cstring>
 #include <openssl/sha.h> // or any SHA256 implementation you prefer
 
 #include "convolution.hpp" // your Convolver, Image, Kernel
+#include "synthetic.hpp"
+#include "static_kernel.hpp"
+#include "jit.hpp"
+#include "large_kernel.hpp"
+#include "fft.hpp"
+#include "memory_budget.hpp"
+#include <filesystem>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 // Compute SHA256 of a byte buffer
-std::string sha256(const std::vector<unsigned char> &data)
+template <class Bytes>
+std::string sha256(const Bytes &data)
 {
     uint8_t hash[SHA256_DIGEST_LENGTH];
     SHA256(data.data(), data.size(), hash);
@@ -18,10 +30,31 @@ std::string sha256(const std::vector<unsigned char> &data)
     return oss.str();
 }
 
+// Pixels without the row padding (padding bytes are uninitialized)
+std::vector<unsigned char> packed(const Image &img)
+{
+    std::vector<unsigned char> bytes(size_t(img.width) * img.height * img.nChannels);
+    img.copy_packed(bytes.data());
+    return bytes;
+}
+
+// Largest per-channel difference between two images of the same size
+int max_difference(const Image &a, const Image &b)
+{
+    int max_diff = 0;
+    for (int y = 0; y < a.height; y++)
+        for (int x = 0; x < a.width; x++)
+            for (int c = 0; c < a.nChannels; c++)
+                max_diff = std::max(max_diff, std::abs(a.get(x, y, c) - b.get(x, y, c)));
+    return max_diff;
+}
+
 int main()
 {
-    // Load your test image
-    Image img = Image::load("test.png");
+    // Load your test image (or generate one when running without the repo assets)
+    Image img = std::filesystem::exists("test.png")
+                    ? Image::load("test.png")
+                    : SyntheticImage::generate(640, 480, 3, SyntheticPattern::Texture, 42);
 
     // Example 3×3 kernel
     ConvolutionKernel kernel({{0.f, -1.f, 0.f},
@@ -35,19 +68,466 @@ int main()
     ConvolutionResult out_simd = conv.do_convolve(img, kernel, 1);
 
     // Hash both outputs
-    std::string h_linear = sha256(out_linear.output.data);
-    std::string h_simd = sha256(out_simd.output.data);
+    std::string h_linear = sha256(packed(out_linear.output));
+    std::string h_simd = sha256(packed(out_simd.output));
 
     std::cout << "Linear SHA256: " << h_linear << "\n";
     std::cout << "SIMD   SHA256: " << h_simd << "\n";
 
-    if (h_linear == h_simd)
+    if (h_linear != h_simd)
+    {
+        std::cout << "Images DIFFER.\n";
+        return 1;
+    }
+    std::cout << "Images are IDENTICAL.\n";
+
+    // Every other exact backend must match the scalar reference as well.
+    for (Backend backend : Convolver::backends())
+    {
+        if (!Convolver::bit_exact(backend))
+            continue;
+        std::string h = sha256(packed(conv.do_convolve(img, kernel, backend).output));
+        std::cout << Convolver::backend_name(backend) << ": " << (h == h_linear ? "IDENTICAL" : "DIFFER") << "\n";
+        if (h != h_linear)
+            return 1;
+    }
+
+    // Region of interest: convolving a view (with one pixel of context) into a
+    // view of another canvas must match the same region of the full result.
+    {
+        const int rx = 10, ry = 7, rw = 41, rh = 23;
+        Image canvas(img.width, img.height, img.nChannels);
+        conv.apply_simd(img.view(rx - 1, ry - 1, rw + 2, rh + 2),
+                        canvas.view(rx - 1, ry - 1, rw + 2, rh + 2), kernel);
+
+        bool same = true;
+        for (int y = ry; y < ry + rh; y++)
+            for (int x = rx; x < rx + rw; x++)
+                for (int c = 0; c < img.nChannels; c++)
+                    same = same && canvas.get(x, y, c) == out_linear.output.get(x, y, c);
+        std::cout << "ROI view: " << (same ? "IDENTICAL" : "DIFFER") << "\n";
+        if (!same)
+            return 1;
+    }
+
+    // Convolving into a reused buffer, with streaming stores, and iterating
+    // with a DoubleBuffer must match the allocating path.
+    {
+        Image reused(1, 1, 3); // wrong size on purpose: do_convolve reshapes it
+        conv.do_convolve(img, reused, kernel, Backend::Simd);
+        bool same = sha256(packed(reused)) == h_linear;
+
+        Convolver streaming;
+        streaming.set_store_mode(StoreMode::Streaming);
+        Image streamed;
+        streaming.do_convolve(img, streamed, kernel, Backend::Simd);
+        same = same && sha256(packed(streamed)) == h_linear;
+
+        DoubleBuffer buffers{Image(img)};
+        conv.iterate(buffers, kernel, 2, Backend::Simd);
+        Image twice = conv.do_convolve(out_linear.output, kernel, Backend::Linear).output;
+        same = same && sha256(packed(buffers.front())) == sha256(packed(twice));
+
+        Image in_place = img;
+        conv.apply_in_place(in_place, kernel, Backend::Simd);
+        same = same && sha256(packed(in_place)) == h_linear;
+
+        std::cout << "Into buffer / streaming / iterate / in place: " << (same ? "IDENTICAL" : "DIFFER") << "\n";
+        if (!same)
+            return 1;
+    }
+
+    // Gray and RGBA input, and every byte-stream step width the CPU supports
+    for (int channels : {1, 2, 4})
+    {
+        Image multi = SyntheticImage::generate(97, 41, channels, SyntheticPattern::Noise, 11);
+        std::string a = sha256(packed(conv.do_convolve(multi, kernel, Backend::Linear).output));
+        for (Backend backend : Convolver::backends())
+        {
+            if (!Convolver::bit_exact(backend))
+                continue;
+            std::string b = sha256(packed(conv.do_convolve(multi, kernel, backend).output));
+            std::cout << channels << " channels " << Convolver::backend_name(backend) << ": "
+                      << (a == b ? "IDENTICAL" : "DIFFER") << "\n";
+            if (a != b)
+                return 1;
+        }
+        for (int bytes : Convolver::byte_stream_bytes_supported())
+        {
+            Convolver::set_byte_stream_bytes(bytes);
+            std::string b = sha256(packed(conv.do_convolve(multi, kernel, Backend::ByteStream).output));
+            std::cout << channels << " channels bytestream/" << bytes << ": "
+                      << (a == b ? "IDENTICAL" : "DIFFER") << "\n";
+            if (a != b)
+                return 1;
+        }
+        Convolver::set_byte_stream_bytes(0);
+        for (int bytes : Convolver::byte_stream_bytes_supported())
+        {
+            Convolver::set_blocked_vector_bytes(bytes);
+            Image in_place = multi;
+            conv.apply_in_place(in_place, kernel, Backend::Blocked);
+            std::string b = sha256(packed(conv.do_convolve(multi, kernel, Backend::Blocked).output));
+            bool same = a == b && a == sha256(packed(in_place));
+            std::cout << channels << " channels blocked/" << bytes << ": "
+                      << (same ? "IDENTICAL" : "DIFFER") << "\n";
+            if (!same)
+                return 1;
+        }
+        Convolver::set_blocked_vector_bytes(0);
+    }
+
+    // Inexact backends (fused multiply-add) may round differently, by at most
+    // one level; weights that are not exact in binary exercise that.
+    {
+        ConvolutionKernel soft({{0.1f, 0.15f, 0.1f},
+                                {0.15f, -0.3f, 0.15f},
+                                {0.1f, 0.15f, 0.1f}});
+        for (Backend backend : Convolver::backends())
+        {
+            if (Convolver::bit_exact(backend))
+                continue;
+            for (int channels : {1, 3, 4})
+            {
+                Image input = SyntheticImage::generate(131, 29, channels, SyntheticPattern::Noise, 5);
+                int max_diff = max_difference(conv.do_convolve(input, soft, backend).output,
+                                              conv.do_convolve(input, soft, Backend::Linear).output);
+                std::cout << Convolver::backend_name(backend) << " " << channels
+                          << " channels: max difference " << max_diff << "\n";
+                if (max_diff > 1)
+                    return 1;
+            }
+        }
+    }
+
+    // Half-precision intermediates: rounding the sum to 11 significant bits
+    // may move the truncated result by at most one.
+    {
+        HalfImage half = HalfImage::from_image(img), filtered;
+        Convolver::apply_half(half, filtered, kernel);
+        Image back;
+        filtered.to_image(back);
+
+        int max_diff = max_difference(back, out_linear.output);
+        std::cout << "Half precision: max difference " << max_diff << "\n";
+        if (max_diff > 1)
+            return 1;
+    }
+
+    // Scalar half conversions must match F16C bit for bit: every half, then
+    // floats at and next to every rounding tie, below the half subnormal range,
+    // past the largest half, infinities and NaNs with payloads.
+    if (HalfImage::f16c_supported())
+    {
+        std::vector<uint16_t> halves(65536);
+        for (size_t h = 0; h < halves.size(); h++)
+            halves[h] = uint16_t(h);
+        std::vector<float> floats(halves.size());
+        HalfImage::to_float(halves.data(), floats.data(), halves.size());
+        bool same = true;
+        for (size_t h = 0; h < halves.size(); h++)
+        {
+            float scalar = HalfImage::half_to_float(halves[h]);
+            same &= std::memcmp(&scalar, &floats[h], sizeof(float)) == 0;
+        }
+
+        std::vector<uint32_t> bits;
+        for (uint32_t h = 0; h < 0x7c00; h++)
+        {
+            float f = HalfImage::half_to_float(uint16_t(h)), next = HalfImage::half_to_float(uint16_t(h + 1));
+            uint32_t a, b;
+            std::memcpy(&a, &f, sizeof(a));
+            std::memcpy(&b, &next, sizeof(b));
+            const uint32_t tie = a + (b - a) / 2;
+            for (uint32_t v : {a, tie - 1, tie, tie + 1})
+                bits.insert(bits.end(), {v, v | 0x80000000u});
+        }
+        for (uint32_t v = 0; v < 0x4000; v += 7) // float subnormals
+            bits.push_back(v);
+        for (uint32_t v = 0x33000000; v < 0x33800000; v += 0x1001) // around 2^-25
+            bits.push_back(v);
+        for (uint32_t v : {0x477fe000u, 0x477fefffu, 0x477ff000u, 0x477ff001u, 0x47800000u, 0x7f7fffffu,
+                           0x7f800000u, 0x7f800001u, 0x7fa00000u, 0x7fc00000u, 0x7fffffffu, 0xff800000u,
+                           0xffc00001u})
+            bits.push_back(v);
+        while (bits.size() % 8) // whole vectors, so every value takes the F16C path
+            bits.push_back(0);
+
+        std::vector<float> inputs(bits.size());
+        std::memcpy(inputs.data(), bits.data(), bits.size() * sizeof(float));
+        std::vector<uint16_t> converted(inputs.size());
+        HalfImage::from_float(inputs.data(), converted.data(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++)
+            same &= HalfImage::float_to_half(inputs[i]) == converted[i];
+
+        std::cout << "Half conversions: " << (same ? "IDENTICAL" : "DIFFER") << "\n";
+        if (!same)
+            return 1;
+    }
+
+    // Widths that exercise the shifted last SIMD block, the short store next to
+    // the right border and the scalar fallback
+    const int sizes[][2] = {{67, 33}, {11, 5}, {6, 4}, {5, 5}, {3, 3}, {1, 1}};
+    for (const auto &size : sizes)
     {
-        std::cout << "Images are IDENTICAL.\n";
-        return 0;
+        Image small = SyntheticImage::generate(size[0], size[1], 3, SyntheticPattern::Noise, 7);
+        std::string a = sha256(packed(conv.do_convolve(small, kernel, 0).output));
+        for (Backend backend : Convolver::backends())
+        {
+            if (!Convolver::bit_exact(backend))
+                continue;
+            std::string b = sha256(packed(conv.do_convolve(small, kernel, backend).output));
+            std::cout << size[0] << "x" << size[1] << " " << Convolver::backend_name(backend) << ": "
+                      << (a == b ? "IDENTICAL" : "DIFFER") << "\n";
+            if (a != b)
+                return 1;
+        }
     }
 
-    std::cout << "Images DIFFER.\n";
+    // Memory budget: a request larger than the limit waits for everything in
+    // flight to finish instead of deadlocking, and requests that fit pass a
+    // blocked one only kMaxOvertakes times before it is served.
+    {
+        // Gives a thread up to a second to block, so a broken budget fails instead of hanging.
+        auto wait_for = [](const MemoryBudget &budget, uint64_t waits)
+        {
+            for (int ms = 0; ms < 1000 && budget.waits() < waits; ms++)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        };
+
+        MemoryBudget oversized(100);
+        oversized.acquire(30);
+        std::atomic<bool> large_done{false};
+        std::thread large([&]
+                          { oversized.acquire(500); large_done = true; });
+        wait_for(oversized, 1);
+        const bool held = !large_done && oversized.in_use() == 30;
+        oversized.release(30);
+        large.join();
+        const bool admitted = oversized.in_use() == 500 && oversized.peak() == 500 && oversized.waits() == 1;
+        oversized.release(500);
+
+        MemoryBudget budget(200);
+        budget.acquire(150);
+        std::atomic<bool> blocked_done{false}, small_done{false};
+        std::thread blocked([&]
+                            { budget.acquire(100); blocked_done = true; });
+        wait_for(budget, 1);
+        for (int i = 0; i < MemoryBudget::kMaxOvertakes; i++)
+            budget.acquire(5);
+        // The next small request still fits but has used up its overtakes.
+        std::thread small([&]
+                          { budget.acquire(5); small_done = true; });
+        wait_for(budget, 2);
+        const bool fair = !blocked_done && !small_done && budget.in_use() == 150 + 5 * MemoryBudget::kMaxOvertakes;
+        budget.release(150);
+        blocked.join();
+        small.join();
+        const bool served = budget.in_use() == 100 + 5 * (MemoryBudget::kMaxOvertakes + 1) &&
+                            budget.peak() == 150 + 5 * MemoryBudget::kMaxOvertakes && budget.waits() == 2;
+
+        bool parsed = MemoryBudget::parse_size("64M") == size_t(64) << 20 && MemoryBudget::parse_size("3K") == 3072 &&
+                      MemoryBudget::parse_size("4096") == 4096;
+        try
+        {
+            MemoryBudget::parse_size("12X");
+            parsed = false;
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+
+        std::cout << "MemoryBudget: " << (held && admitted && fair && served && parsed ? "OK" : "FAILED") << "\n";
+        if (!held || !admitted || !fair || !served || !parsed)
+            return 1;
+    }
+
+    // Kernel analysis: each strategy of the algebraic backend must reproduce
+    // apply_linear, across several chunks per row and through the row kernel
+    // used in place. The large weights need 32-bit sums.
+    {
+        struct Case
+        {
+            ConvolutionKernel kernel;
+            KernelStrategy expected;
+        };
+        const Case cases[] = {
+            {kernel, KernelStrategy::Sparse},
+            {{{-1, -1, -1}, {-1, 8, -1}, {-1, -1, -1}}, KernelStrategy::BoxPlusCenter},
+            {{{1 / 16.f, 2 / 16.f, 1 / 16.f}, {2 / 16.f, 4 / 16.f, 2 / 16.f}, {1 / 16.f, 2 / 16.f, 1 / 16.f}},
+             KernelStrategy::Separable},
+            {{{3, -7, 2}, {11, -40, 5}, {1, 9, -6}}, KernelStrategy::Sparse},
+            {{{0, 0, 0}, {0, 0, 0}, {0, 0, 0}}, KernelStrategy::Sparse},
+            {{{0.1f, 0.2f, 0.1f}, {0.2f, 0.4f, 0.2f}, {0.1f, 0.2f, 0.1f}}, KernelStrategy::Direct},
+        };
+        for (int channels : {1, 3, 4})
+        {
+            Image input = SyntheticImage::generate(301, 19, channels, SyntheticPattern::Noise, 3);
+            for (const Case &c : cases)
+            {
+                KernelAnalysis analysis = c.kernel.analyze();
+                std::string a = sha256(packed(conv.do_convolve(input, c.kernel, Backend::Linear).output));
+                std::string b = sha256(packed(conv.do_convolve(input, c.kernel, Backend::Algebraic).output));
+                Image in_place = input;
+                conv.apply_in_place(in_place, c.kernel, Backend::Algebraic);
+                bool same = a == b && a == sha256(packed(in_place));
+                std::cout << channels << " channels " << KernelAnalysis::strategy_name(analysis.strategy)
+                          << ": " << (same ? "IDENTICAL" : "DIFFER") << "\n";
+                if (!same || analysis.strategy != c.expected)
+                    return 1;
+            }
+        }
+    }
+
+    // Compile-time kernels: every specialization must match the runtime
+    // reference, through the view API, the backend and the in-place row kernel.
+    // Rows of 20 and 40 interior bytes take the SSE and AVX2 paths even on
+    // AVX-512 hosts, 200 bytes the widest one.
+    for (const StaticKernel &k : {kEdgeKernel, kSharpenKernel, kBlurKernel})
+    {
+        const ConvolutionKernel runtime = k.runtime();
+        if (!Convolver::has_static_kernel(runtime))
+            return 1;
+        for (int channels : {1, 3, 4})
+            for (int interior : {20, 40, 200})
+            {
+                const int width = interior / channels + 2;
+                Image input = SyntheticImage::generate(width, 17, channels, SyntheticPattern::Noise, 9);
+                std::string a = sha256(packed(conv.do_convolve(input, runtime, Backend::Linear).output));
+                Image in_place = input;
+                conv.apply_in_place(in_place, runtime, Backend::Static);
+                bool same = a == sha256(packed(conv.do_convolve(input, runtime, Backend::Static).output)) &&
+                            a == sha256(packed(in_place));
+                std::cout << channels << " channels " << width << " wide static: "
+                          << (same ? "IDENTICAL" : "DIFFER") << "\n";
+                if (!same)
+                    return 1;
+            }
+    }
+    {
+        Image input = SyntheticImage::generate(83, 17, 3, SyntheticPattern::Noise, 9);
+        Image direct = conv.do_convolve(input, kBlurKernel.runtime(), Backend::Linear).output;
+        std::string a = sha256(packed(direct));
+        StaticConvolution<kBlurKernel>::apply(input.view(), direct.view());
+        std::cout << "StaticConvolution<kBlurKernel>: " << (a == sha256(packed(direct)) ? "IDENTICAL" : "DIFFER") << "\n";
+        if (a != sha256(packed(direct)))
+            return 1;
+    }
+
+    // Generated kernels: ±1 first taps, zero taps and more distinct weights
+    // than weight registers must all reproduce apply_linear; a kernel is
+    // generated once per channel count and then reused from the cache.
+    if (KernelJit::supported())
+    {
+        const ConvolutionKernel kernels[] = {
+            kernel,
+            {{-1, 0, 2}, {0, 1, 0}, {3, 0, -1}},
+            {{0.1f, 0.2f, 0.3f}, {0.4f, 0.5f, 0.6f}, {0.7f, 0.8f, -0.9f}},
+            {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+        };
+        for (int pass = 0; pass < 2; pass++)
+        {
+            const size_t generated = KernelJit::cached();
+            for (const ConvolutionKernel &k : kernels)
+                for (int channels : {1, 3, 4})
+                {
+                    Image input = SyntheticImage::generate(83, 17, channels, SyntheticPattern::Noise, 5);
+                    std::string a = sha256(packed(conv.do_convolve(input, k, Backend::Linear).output));
+                    Image in_place = input;
+                    conv.apply_in_place(in_place, k, Backend::Jit);
+                    bool same = a == sha256(packed(conv.do_convolve(input, k, Backend::Jit).output)) &&
+                                a == sha256(packed(in_place));
+                    if (!same)
+                    {
+                        std::cout << channels << " channels jit: DIFFER\n";
+                        return 1;
+                    }
+                }
+            if (pass == 1 && KernelJit::cached() != generated)
+                return 1;
+        }
+        std::cout << "jit: IDENTICAL, " << KernelJit::cached() << " row loops generated\n";
+    }
+
+    // Winograd: the transforms reorder the float sums, so a result may truncate
+    // one level off apply_linear; odd sizes exercise the single-row and
+    // single-column paths, the in-place path uses the one-dimensional F(2, 3).
+    {
+        const ConvolutionKernel kernels[] = {
+            kernel,
+            kBlurKernel.runtime(),
+            {{0.0751f, 0.1238f, 0.0751f}, {0.1238f, 0.2042f, 0.1238f}, {0.0751f, 0.1238f, 0.0751f}},
+            {{0.3f, -1.7f, 0.9f}, {2.1f, 0.45f, -0.6f}, {-1.2f, 0.8f, 1.3f}},
+        };
+        const int sizes[][2] = {{301, 19}, {84, 18}, {5, 4}, {4, 3}, {3, 3}};
+        int max_diff = 0;
+        for (const ConvolutionKernel &k : kernels)
+            for (int channels = 1; channels <= 4; channels++)
+                for (const auto &size : sizes)
+                {
+                    Image input = SyntheticImage::generate(size[0], size[1], channels, SyntheticPattern::Noise, 11);
+                    Image reference = conv.do_convolve(input, k, Backend::Linear).output;
+                    Image in_place = input;
+                    conv.apply_in_place(in_place, k, Backend::Winograd);
+                    max_diff = std::max({max_diff, max_difference(conv.do_convolve(input, k, Backend::Winograd).output, reference),
+                                         max_difference(in_place, reference)});
+                }
+        std::cout << "Winograd: max difference " << max_diff << "\n";
+        if (max_diff > 1)
+            return 1;
+    }
+
+    // Large kernels: the direct method reduces to apply_linear for 3x3, and the
+    // FFT may truncate one level off the direct sums. Images smaller than the
+    // kernel have no interior and come out black.
+    {
+        Image input = SyntheticImage::generate(97, 61, 3, SyntheticPattern::Texture, 13);
+        Image direct(input.width, input.height, input.nChannels);
+        LargeConvolver::apply_direct(input.view(), direct.view(), LargeKernel(kernel));
+        bool same = sha256(packed(direct)) == sha256(packed(conv.do_convolve(input, kernel, Backend::Linear).output));
+        std::cout << "Large direct 3x3: " << (same ? "IDENTICAL" : "DIFFER") << "\n";
+        if (!same)
+            return 1;
+
+        const LargeKernel kernels[] = {LargeKernel::gaussian(4, 2.0f), LargeKernel::unsharp(6, 3.0f, 1.5f),
+                                       LargeKernel(kernel)};
+        const int sizes[][2] = {{97, 61}, {40, 200}, {13, 13}, {5, 5}};
+        int max_diff = 0;
+        for (const LargeKernel &k : kernels)
+            for (int channels : {1, 3, 4})
+                for (const auto &size : sizes)
+                {
+                    Image in = SyntheticImage::generate(size[0], size[1], channels, SyntheticPattern::Noise, 17);
+                    Image a(in.width, in.height, channels), b(in.width, in.height, channels);
+                    LargeConvolver::apply_direct(in.view(), a.view(), k);
+                    LargeConvolver::apply_fft(in.view(), b.view(), k);
+                    max_diff = std::max(max_diff, max_difference(a, b));
+                }
+        std::cout << "Large FFT: max difference " << max_diff << "\n";
+
+        // A unit impulse has a flat spectrum, and the inverse restores it.
+        Fft fft(64);
+        std::vector<Fft::Complex> impulse(64);
+        impulse[3] = 1;
+        fft.transform(impulse.data(), false);
+        bool flat = true;
+        for (const Fft::Complex &v : impulse)
+            flat &= std::abs(std::abs(v) - 1.0f) < 1e-5f;
+        fft.transform(impulse.data(), true);
+        flat &= std::abs(impulse[3] - Fft::Complex(1, 0)) < 1e-5f && std::abs(impulse[4]) < 1e-5f;
+
+        Image tiny = SyntheticImage::generate(9, 9, 3, SyntheticPattern::Noise, 1), black(9, 9, 3);
+        LargeConvolver::apply(tiny.view(), black.view(), LargeKernel::gaussian(5, 2.0f));
+        bool all_zero = true;
+        for (unsigned char v : packed(black))
+            all_zero &= v == 0;
+
+        const bool chosen = LargeConvolver::choose(LargeKernel(kernel), 1920, 1080, 3) == LargeMethod::Direct &&
+                            LargeConvolver::choose(LargeKernel::gaussian(20, 8.0f), 1920, 1080, 3) == LargeMethod::Fft;
+        if (max_diff > 1 || !all_zero || !chosen || !flat)
+            return 1;
+    }
 
     /*
     // Optional: find first differing pixel